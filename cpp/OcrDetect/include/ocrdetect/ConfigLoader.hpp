@@ -8,6 +8,7 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include <cctype>
@@ -26,9 +27,35 @@ struct OcrDetectOptions {
   int do_angle;
   int most_angle;
   int num_threads;
+  int det_num_threads;   /**< det 算子内线程数（可选，0 表示沿用 num_threads） */
+  int cls_num_threads;   /**< cls 算子内线程数（可选，0 表示沿用 num_threads） */
+  int rec_num_threads;   /**< rec 算子内线程数（可选，0 表示沿用 num_threads） */
+  int allow_spinning;    /**< 线程池空闲自旋（可选，默认 1） */
+  int global_thread_pool;            /**< 进程级全局线程池（可选，默认 0） */
+  int global_intra_threads;          /**< 全局算子内线程数（可选，默认 0 = ORT 决定） */
+  int global_inter_threads;          /**< 全局节点间线程数（可选，默认 1） */
+  std::string global_thread_affinity; /**< 全局 intra-op 线程绑核（可选，默认不绑定） */
+  int cls_batch_num;     /**< 方向分类批大小（可选，默认 6） */
+  int rec_batch_num;     /**< 识别批大小（可选，默认 6） */
+  std::string model_cache_dir;       /**< 优化后模型缓存目录（可选，默认空 = 不缓存） */
+  int use_mmap;                      /**< 从内存映射加载模型（可选，默认 0） */
+  std::string model_precision;       /**< 模型精度 fp32 / int8（可选，默认 fp32） */
+  int fused_crop;                    /**< 融合裁剪（可选，默认 0） */
+  int det_tile_size;                 /**< 分块检测的分块边长（可选，默认 0 = 不分块） */
+  int det_tile_overlap;              /**< 分块重叠宽度（可选，默认 128） */
+  int fast_db_postprocess;           /**< DB 快速后处理（可选，默认 0） */
+  int db_rect_score;                 /**< DB 框得分取外接矩形均值（可选，默认 0） */
+  int db_scanline_score;             /**< DB 框得分逐行扫描轮廓多边形（可选，默认 0） */
+  std::vector<int> det_shape_buckets; /**< det 输入形状分桶边长（可选，逗号分隔，默认空 = 不分桶） */
+  int rec_split_width;               /**< 长行分窗识别的窗口宽度（可选，默认 0 = 不分窗） */
+  int rec_split_overlap;             /**< 分窗重叠宽度（可选，默认 96） */
+  int cls_sample_num;                /**< 多数方向抽样的每图最多样本数（可选，默认 0 = 不抽样） */
 };
 
-/** 从 key=value 配置文件加载 OcrDetectOptions，无默认值，缺失则抛出 std::runtime_error */
+/**
+ * 从 key=value 配置文件加载 OcrDetectOptions，基础参数无默认值，缺失则抛出 std::runtime_error；
+ * 后续新增的调优参数为可选项，缺失时使用注释中的默认值，兼容旧配置文件
+ */
 inline OcrDetectOptions loadOcrDetectConfigFromFile(const std::string& path) {
   std::ifstream f(path);
   if (!f.is_open())
@@ -64,6 +91,14 @@ inline OcrDetectOptions loadOcrDetectConfigFromFile(const std::string& path) {
       throw std::runtime_error(std::string("配置缺失: ") + k + " (文件: " + path + ")");
     return std::stof(it->second);
   };
+  auto getIntOr = [&kv](const char* k, int def) {
+    auto it = kv.find(k);
+    return it == kv.end() || it->second.empty() ? def : std::stoi(it->second);
+  };
+  auto getStringOr = [&kv](const char* k, const std::string& def) {
+    auto it = kv.find(k);
+    return it == kv.end() ? def : it->second;
+  };
 
   OcrDetectOptions opt{};
   opt.padding = getInt("padding");
@@ -75,6 +110,36 @@ inline OcrDetectOptions loadOcrDetectConfigFromFile(const std::string& path) {
   opt.do_angle = getInt("do_angle");
   opt.most_angle = getInt("most_angle");
   opt.num_threads = getInt("num_threads");
+  opt.det_num_threads = getIntOr("det_num_threads", 0);
+  opt.cls_num_threads = getIntOr("cls_num_threads", 0);
+  opt.rec_num_threads = getIntOr("rec_num_threads", 0);
+  opt.allow_spinning = getIntOr("allow_spinning", 1);
+  opt.global_thread_pool = getIntOr("global_thread_pool", 0);
+  opt.global_intra_threads = getIntOr("global_intra_threads", 0);
+  opt.global_inter_threads = getIntOr("global_inter_threads", 1);
+  opt.global_thread_affinity = getStringOr("global_thread_affinity", "");
+  opt.cls_batch_num = getIntOr("cls_batch_num", 6);
+  opt.rec_batch_num = getIntOr("rec_batch_num", 6);
+  opt.model_cache_dir = getStringOr("model_cache_dir", "");
+  opt.use_mmap = getIntOr("use_mmap", 0);
+  opt.model_precision = getStringOr("model_precision", "fp32");
+  opt.fused_crop = getIntOr("fused_crop", 0);
+  opt.det_tile_size = getIntOr("det_tile_size", 0);
+  opt.det_tile_overlap = getIntOr("det_tile_overlap", 128);
+  opt.fast_db_postprocess = getIntOr("fast_db_postprocess", 0);
+  opt.db_rect_score = getIntOr("db_rect_score", 0);
+  opt.db_scanline_score = getIntOr("db_scanline_score", 0);
+  {
+    std::stringstream buckets(getStringOr("det_shape_buckets", ""));
+    std::string item;
+    while (std::getline(buckets, item, ',')) {
+      if (item.find_first_not_of(" \t") != std::string::npos)
+        opt.det_shape_buckets.push_back(std::stoi(item));
+    }
+  }
+  opt.rec_split_width = getIntOr("rec_split_width", 0);
+  opt.rec_split_overlap = getIntOr("rec_split_overlap", 96);
+  opt.cls_sample_num = getIntOr("cls_sample_num", 0);
   return opt;
 }
 
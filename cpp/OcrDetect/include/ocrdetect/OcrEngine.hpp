@@ -11,6 +11,7 @@
 #include "ocr_api.h"
 #include "ConfigLoader.hpp"
 #include <opencv2/core.hpp>
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
@@ -24,11 +25,66 @@ struct TextBlock {
   float confidence;
 };
 
+/** C 结果块 -> TextBlock（复制 text） */
+inline TextBlock toTextBlock(const OCR_TextBlock& c) {
+  TextBlock b;
+  for (int k = 0; k < 4; k++) {
+    b.box[k][0] = static_cast<float>(c.box[k].x);
+    b.box[k][1] = static_cast<float>(c.box[k].y);
+  }
+  b.box_score = c.box_score;
+  b.text = c.text ? c.text : "";
+  b.confidence = c.confidence;
+  return b;
+}
+
+/** 将 OCR_Options 填为配置中的检测参数 */
+inline OCR_Options toOcrOptions(const OcrDetectOptions& opt, bool use_crop_len = false) {
+  OCR_Options o = {};
+  o.padding = opt.padding;
+  o.short_side_len = use_crop_len ? opt.crop_short_side_len : opt.short_side_len;
+  o.box_score_thresh = opt.box_score_thresh;
+  o.box_thresh = opt.box_thresh;
+  o.un_clip_ratio = opt.un_clip_ratio;
+  o.do_angle = opt.do_angle;
+  o.most_angle = opt.most_angle;
+  return o;
+}
+
 class OcrEngine {
 public:
+  /**
+   * 按配置启用进程级全局线程池（global_thread_pool=1 时），须在创建第一个 OcrEngine 前调用
+   * @return 未启用或设置成功返回 true；已有引擎创建导致设置失败返回 false
+   */
+  static bool configureGlobalThreadPool(const OcrDetectOptions& opt) {
+    if (!opt.global_thread_pool) return true;
+    return ocr_set_global_thread_pool(opt.global_intra_threads, opt.global_inter_threads,
+      opt.global_thread_affinity.c_str(), opt.allow_spinning) == 0;
+  }
+
   /** 创建时直接加载模型；models_dir 含 det.onnx, cls.onnx, rec.onnx, ppocr_keys_v1.txt 或 keys.txt */
   explicit OcrEngine(const std::string& models_dir)
     : handle_(ocr_create(models_dir.c_str())) {}
+
+  /**
+   * 按配置创建：线程参数、模型缓存目录（model_cache_dir）、use_mmap 与模型精度（model_precision）在会话创建时生效，
+   * 启动时只做一次图优化
+   * 其余参数同 applyOptions
+   */
+  OcrEngine(const std::string& models_dir, const OcrDetectOptions& opt) {
+    OCR_CreateOptions co = {};
+    co.model_cache_dir = opt.model_cache_dir.c_str();
+    co.det_num_threads = opt.det_num_threads > 0 ? opt.det_num_threads : opt.num_threads;
+    co.cls_num_threads = opt.cls_num_threads > 0 ? opt.cls_num_threads : opt.num_threads;
+    co.rec_num_threads = opt.rec_num_threads > 0 ? opt.rec_num_threads : opt.num_threads;
+    co.disable_spinning = opt.allow_spinning ? 0 : 1;
+    co.use_mmap = opt.use_mmap;
+    co.precision = opt.model_precision == "int8" ? OCR_PRECISION_INT8 : OCR_PRECISION_FP32;
+    handle_ = ocr_create_ex(models_dir.c_str(), &co);
+    applyOptions(opt);
+  }
+
   ~OcrEngine() { if (handle_) ocr_destroy(handle_); }
 
   OcrEngine(const OcrEngine&) = delete;
@@ -38,6 +94,48 @@ public:
 
   void setNumThreads(int n) { if (handle_) ocr_set_num_threads(handle_, n); }
 
+  /** 分别设置 det/cls/rec 线程数，<=0 的项保持不变 */
+  void setModelThreads(int det, int cls, int rec) {
+    if (handle_) ocr_set_model_threads(handle_, det, cls, rec);
+  }
+
+  /** 设置线程池空闲自旋 */
+  void setThreadSpinning(bool allow) { if (handle_) ocr_set_thread_spinning(handle_, allow ? 1 : 0); }
+
+  /** 设置方向分类批大小 */
+  void setClsBatchNum(int n) { if (handle_) ocr_set_cls_batch_num(handle_, n); }
+
+  /** 设置识别批大小 */
+  void setRecBatchNum(int n) { if (handle_) ocr_set_rec_batch_num(handle_, n); }
+
+  /** 融合裁剪：cls/rec 从原图一次采样到输入尺寸，不生成中间裁剪图 */
+  void setFusedCrop(bool enable) { if (handle_) ocr_set_fused_crop(handle_, enable ? 1 : 0); }
+
+  /** 分块检测：原图超过 tileSize 时按原分辨率分块检测并合并接缝处的文本框，tileSize<=0 关闭 */
+  void setDetTiling(int tileSize, int overlap) { if (handle_) ocr_set_det_tiling(handle_, tileSize, overlap); }
+
+  /** DB 快速后处理：连通域一次标记 + 解析外扩，文本框多时更快 */
+  void setFastDbPostprocess(bool enable) { if (handle_) ocr_set_fast_db_postprocess(handle_, enable ? 1 : 0); }
+
+  /** DB 框得分取外接矩形均值（积分图），代替掩码求轮廓多边形内均值 */
+  void setDbRectScore(bool enable) { if (handle_) ocr_set_db_rect_score(handle_, enable ? 1 : 0); }
+
+  /** DB 框得分逐行扫描轮廓多边形，不分配掩码；边界像素与 fillPoly 略有差异 */
+  void setDbScanlineScore(bool enable) { if (handle_) ocr_set_db_scanline_score(handle_, enable ? 1 : 0); }
+
+  /** det 输入形状分桶：宽高补齐到桶边长并立即预热，空表示关闭；桶未变化时为空操作 */
+  void setDetShapeBuckets(const std::vector<int>& sizes) {
+    if (handle_) ocr_set_det_shape_buckets(handle_, sizes.data(), (int)sizes.size());
+  }
+
+  /** 长行分窗识别：宽于 windowWidth 的文本块切成重叠窗口组批识别后拼接，windowWidth<=0 关闭 */
+  void setRecLineSplit(int windowWidth, int overlap) {
+    if (handle_) ocr_set_rec_line_split(handle_, windowWidth, overlap);
+  }
+
+  /** 多数方向抽样：most_angle 时每张图最多分类 maxSamples 个最大文本块，投票确定后提前停止，<=0 关闭 */
+  void setClsSampling(int maxSamples) { if (handle_) ocr_set_cls_sampling(handle_, maxSamples); }
+
   /** 设置预处理图像保存路径（调试用），下次 detect 时保存预处理结果 */
   void setPreprocessSavePath(const std::string& path) {
     if (handle_) ocr_set_preprocess_save_path(handle_, path.c_str());
@@ -48,9 +146,31 @@ public:
     if (handle_) ocr_set_part_imgs_save_path(handle_, path.c_str());
   }
 
+  /**
+   * 应用配置文件中的引擎参数（线程、批大小等）；参数未变化时为空操作，可在每次检测前调用
+   * 线程数变化会重建会话，建议在加载后调用一次
+   */
+  void applyOptions(const OcrDetectOptions& opt) {
+    setModelThreads(
+      opt.det_num_threads > 0 ? opt.det_num_threads : opt.num_threads,
+      opt.cls_num_threads > 0 ? opt.cls_num_threads : opt.num_threads,
+      opt.rec_num_threads > 0 ? opt.rec_num_threads : opt.num_threads);
+    setThreadSpinning(opt.allow_spinning != 0);
+    setClsBatchNum(opt.cls_batch_num);
+    setRecBatchNum(opt.rec_batch_num);
+    setFusedCrop(opt.fused_crop != 0);
+    setDetTiling(opt.det_tile_size, opt.det_tile_overlap);
+    setFastDbPostprocess(opt.fast_db_postprocess != 0);
+    setDbRectScore(opt.db_rect_score != 0);
+    setDbScanlineScore(opt.db_scanline_score != 0);
+    setDetShapeBuckets(opt.det_shape_buckets);
+    setRecLineSplit(opt.rec_split_width, opt.rec_split_overlap);
+    setClsSampling(opt.cls_sample_num);
+  }
+
   /** 使用 OcrDetectOptions 检测（从配置文件加载），use_crop_len=true 时用 crop_short_side_len */
   std::vector<TextBlock> detect(const cv::Mat& image, const OcrDetectOptions& opt, bool use_crop_len = false) {
-    setNumThreads(opt.num_threads);
+    applyOptions(opt);
     int shortLen = use_crop_len ? opt.crop_short_side_len : opt.short_side_len;
     return detect(image, opt.padding, shortLen,
       opt.box_score_thresh, opt.box_thresh, opt.un_clip_ratio,
@@ -80,23 +200,148 @@ public:
     std::vector<OCR_TextBlockCpp> cpp_blocks;
     int n = ocr_detect_mat(handle_, image, &opt, cpp_blocks);
     if (n <= 0) return out;
-    out.reserve(n);
-    for (int i = 0; i < n; i++) {
+    return toTextBlocks(cpp_blocks);
+  }
+
+  /**
+   * 批量检测多张图：所有图的裁剪块合并做批量方向分类与识别，返回与 images 一一对应的结果
+   * 大量小图（如文档扫描件）时比逐张 detect 调用更少、识别批更满
+   */
+  std::vector<std::vector<TextBlock>> detectBatch(const std::vector<cv::Mat>& images,
+    const OcrDetectOptions& opt, bool use_crop_len = false) {
+    std::vector<std::vector<TextBlock>> out;
+    if (!handle_) return out;
+    applyOptions(opt);
+    OCR_Options o = toOcrOptions(opt, use_crop_len);
+    std::vector<std::vector<OCR_TextBlockCpp>> cpp_blocks;
+    if (ocr_detect_mat_batch(handle_, images, &o, cpp_blocks) < 0) return out;
+    out.reserve(cpp_blocks.size());
+    for (auto& blocks : cpp_blocks) out.push_back(toTextBlocks(blocks));
+    return out;
+  }
+
+  OCR_Handle nativeHandle() const { return handle_; }
+
+private:
+  OCR_Handle handle_ = nullptr;
+
+  static std::vector<TextBlock> toTextBlocks(std::vector<OCR_TextBlockCpp>& cpp_blocks) {
+    std::vector<TextBlock> out;
+    out.reserve(cpp_blocks.size());
+    for (auto& c : cpp_blocks) {
       TextBlock b;
       for (int k = 0; k < 4; k++) {
-        b.box[k][0] = cpp_blocks[i].box[k][0];
-        b.box[k][1] = cpp_blocks[i].box[k][1];
+        b.box[k][0] = c.box[k][0];
+        b.box[k][1] = c.box[k][1];
       }
-      b.box_score = cpp_blocks[i].box_score;
-      b.text = std::move(cpp_blocks[i].text);
-      b.confidence = cpp_blocks[i].confidence;
+      b.box_score = c.box_score;
+      b.text = std::move(c.text);
+      b.confidence = c.confidence;
       out.push_back(std::move(b));
     }
     return out;
   }
+};
+
+/**
+ * 多帧流水线（RAII，基于 ocr_pipeline_* C API）
+ * det 与 cls/rec 在两个线程中重叠执行，结果按提交顺序取出；存续期间 engine 只能由流水线使用
+ */
+class OcrPipeline {
+public:
+  OcrPipeline(OcrEngine& engine, int queue_depth = 4)
+    : handle_(engine.valid() ? ocr_pipeline_create(engine.nativeHandle(), queue_depth) : nullptr) {}
+  ~OcrPipeline() { if (handle_) ocr_pipeline_destroy(handle_); }
+
+  OcrPipeline(const OcrPipeline&) = delete;
+  OcrPipeline& operator=(const OcrPipeline&) = delete;
+
+  bool valid() const { return handle_ != nullptr; }
+
+  /**
+   * 提交一帧（不复制像素，处理完成前不可改写 image）
+   * @return 帧序号；队列满（blocking=false）或已停止返回 -1，参数错误 -2
+   */
+  long long submit(const cv::Mat& image, const OcrDetectOptions& opt, bool use_crop_len = false,
+                   bool blocking = true) {
+    if (!handle_) return -2;
+    OCR_Options o = toOcrOptions(opt, use_crop_len);
+    return ocr_pipeline_submit_mat(handle_, image, &o, blocking ? 1 : 0);
+  }
+
+  /**
+   * 按提交顺序取下一帧结果
+   * @param timeout_ms <0 无限等待
+   * @param ok 输出该帧是否处理成功，可为 nullptr
+   * @return 超时返回 false
+   */
+  bool poll(long long& seq, std::vector<TextBlock>& blocks, int timeout_ms = -1, bool* ok = nullptr) {
+    blocks.clear();
+    if (!handle_) return false;
+    OCR_Result r = {};
+    if (ocr_pipeline_poll(handle_, timeout_ms, &seq, &r) != 1) return false;
+    if (ok) *ok = r.count >= 0;
+    blocks.reserve(r.count > 0 ? r.count : 0);
+    for (int i = 0; i < r.count; i++) blocks.push_back(toTextBlock(r.blocks[i]));
+    ocr_free_result(&r);
+    return true;
+  }
 
 private:
-  OCR_Handle handle_ = nullptr;
+  OCR_Pipeline handle_ = nullptr;
+};
+
+/**
+ * 流式分带检测（RAII，基于 ocr_stream_* C API）
+ * 长图按行分批送入，每个带完成即回调输出该带的文本块（整图坐标），跨带的框只输出一次；
+ * 内存只与带高有关。存续期间 engine 只能由该对象使用
+ */
+class OcrStream {
+public:
+  typedef std::function<void(std::vector<TextBlock>& blocks)> Callback;
+
+  /**
+   * @param pixel_format OCR_PixelFormat
+   * @param band_height  带高（行）
+   * @param overlap      相邻带重叠行数，应大于最大文字高度
+   * @param use_crop_len true 时每个带按 crop_short_side_len 缩放，否则按 short_side_len（长图建议配置为 0）
+   */
+  OcrStream(OcrEngine& engine, int width, int pixel_format, const OcrDetectOptions& opt, Callback callback,
+            int band_height = 2048, int overlap = 128, bool use_crop_len = false)
+    : callback_(std::move(callback)) {
+    if (!engine.valid()) return;
+    engine.applyOptions(opt);
+    OCR_Options o = toOcrOptions(opt, use_crop_len);
+    handle_ = ocr_stream_create(engine.nativeHandle(), width, pixel_format, band_height, overlap,
+                                &o, &OcrStream::onBlocks, this);
+  }
+  ~OcrStream() { if (handle_) ocr_stream_destroy(handle_); }
+
+  OcrStream(const OcrStream&) = delete;
+  OcrStream& operator=(const OcrStream&) = delete;
+
+  bool valid() const { return handle_ != nullptr; }
+
+  /** 送入若干行（宽度、像素格式与构造时一致，可为 ROI），返回后可复用 rows 的缓冲区 */
+  bool push(const cv::Mat& rows) {
+    if (!handle_ || rows.empty()) return false;
+    return ocr_stream_push(handle_, rows.data, rows.rows, static_cast<int>(rows.step)) == 0;
+  }
+
+  /** 图像结束，输出最后一个带 */
+  bool finish() { return handle_ && ocr_stream_finish(handle_) == 0; }
+
+private:
+  OCR_Stream handle_ = nullptr;
+  Callback callback_;
+
+  static void OCRDETECT_OCR_CALL onBlocks(void* user, const OCR_TextBlock* blocks, int count) {
+    OcrStream* self = static_cast<OcrStream*>(user);
+    std::vector<TextBlock> out;
+    out.reserve(count);
+    for (int i = 0; i < count; i++) out.push_back(toTextBlock(blocks[i]));
+    if (self->callback_) self->callback_(out);
+  }
 };
 
 } // namespace ocrdetect
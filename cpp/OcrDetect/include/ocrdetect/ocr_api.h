@@ -19,6 +19,12 @@ extern "C" {
 
 typedef void* OCR_Handle;
 
+/** 多帧流水线句柄（ocr_pipeline_create） */
+typedef void* OCR_Pipeline;
+
+/** 流式分带检测句柄（ocr_stream_create） */
+typedef void* OCR_Stream;
+
 /** 单点 (x,y) */
 typedef struct OCR_Point { double x, y; } OCR_Point;
 
@@ -41,30 +47,177 @@ typedef struct OCR_TextBlock {
   float confidence;
 } OCR_TextBlock;
 
-/** 检测结果（调用方分配 OCR_TextBlock 数组，库填充；或使用 ocr_detect_alloc 返回需 ocr_free_result 释放） */
+/** 模型精度（OCR_CreateOptions::precision） */
+typedef enum OCR_Precision {
+  OCR_PRECISION_FP32 = 0,  /**< 加载 det.onnx / cls.onnx / rec.onnx */
+  OCR_PRECISION_INT8 = 1   /**< 各模型优先加载 <名称>.int8.onnx（动态量化），不存在时回退 FP32 */
+} OCR_Precision;
+
+/** 引擎创建选项（ocr_create_ex），全部置 0 即为 ocr_create 的默认行为 */
+typedef struct OCR_CreateOptions {
+  const char* model_cache_dir; /**< 优化后模型缓存目录（UTF-8），NULL 或空表示不缓存 */
+  int det_num_threads;         /**< det 算子内线程数，0 表示由 ORT 决定 */
+  int cls_num_threads;         /**< cls 算子内线程数，0 表示由 ORT 决定 */
+  int rec_num_threads;         /**< rec 算子内线程数，0 表示由 ORT 决定 */
+  int disable_spinning;        /**< 1 关闭线程池空闲自旋 */
+  int use_mmap;                /**< 1 从只读内存映射加载模型，配合 model_cache_dir 时多进程共享权重内存 */
+  int precision;               /**< OCR_Precision，INT8 变体由 python/quantize_models.py 离线生成 */
+} OCR_CreateOptions;
+
+/** 输入像素格式（ocr_detect_ex / OCR_Image），均为每通道 8 位、交错存储 */
+typedef enum OCR_PixelFormat {
+  OCR_PIXEL_BGR = 0,
+  OCR_PIXEL_RGB = 1,
+  OCR_PIXEL_BGRA = 2,
+  OCR_PIXEL_RGBA = 3,
+  OCR_PIXEL_GRAY = 4
+} OCR_PixelFormat;
+
+/** 单张输入图像（ocr_detect_batch），像素直接引用调用方内存，不复制 */
+typedef struct OCR_Image {
+  const unsigned char* data; /**< 首行首像素地址，调用期间须保持有效 */
+  int width;
+  int height;
+  int stride;                /**< 行步长（字节），0 表示紧密排列（width * 每像素字节数） */
+  int pixel_format;          /**< OCR_PixelFormat */
+} OCR_Image;
+
+/** 检测结果（blocks 由库分配，需 ocr_free_result 释放） */
 typedef struct OCR_Result {
   int count;
   OCR_TextBlock* blocks;
   double detect_time_ms;
 } OCR_Result;
 
+/**
+ * 启用进程级全局 ORT 线程池：进程内所有引擎的 det/cls/rec 会话共用一组线程，
+ * 避免多个引擎（及各自的私有线程池）争抢同一批 CPU 核
+ * 必须在第一次 ocr_create 之前调用；启用后 ocr_set_num_threads 等会话级线程设置不再生效
+ * @param intra_threads 全局算子内线程数，0 表示由 ORT 决定
+ * @param inter_threads 全局节点间线程数（顺序执行时 1 即可）
+ * @param affinity      intra-op 线程绑核（ORT 格式，如 "1,2;3,4"，共 intra_threads-1 组），NULL 或空表示不绑定
+ * @param allow_spinning 线程池空闲时是否自旋
+ * @return 0 成功，-1 表示已有引擎创建（共享环境已初始化）
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_set_global_thread_pool(
+  int intra_threads, int inter_threads, const char* affinity, int allow_spinning);
+
 /**
  * 创建 OCR 引擎并直接加载模型
+ * 同一句柄不可被多个线程同时使用；并发检测请为每个线程创建独立句柄（如对象池）
  * @param models_dir 模型目录路径（UTF-8），内含 det.onnx、cls.onnx、rec.onnx、ppocr_keys_v1.txt 或 keys.txt
  * @return 句柄，失败返回 NULL
  */
 OCRDETECT_OCR_API OCR_Handle OCRDETECT_OCR_CALL ocr_create(const char* models_dir);
 
+/**
+ * 按选项创建 OCR 引擎：线程参数在会话创建时即生效（无需创建后再重建会话），
+ * 设置 model_cache_dir 时首次加载把图优化结果写入缓存，之后的启动直接加载缓存
+ * 缓存以模型内容哈希与 ORT 版本为键，替换模型或升级 ORT 后自动重建
+ * 设置 use_mmap 时会话直接引用映射的 ORT 格式模型字节，同机多个进程共享同一份权重物理页
+ * @param models_dir 同 ocr_create
+ * @param options    可为 NULL，等同 ocr_create
+ * @return 句柄，失败返回 NULL
+ */
+OCRDETECT_OCR_API OCR_Handle OCRDETECT_OCR_CALL ocr_create_ex(const char* models_dir,
+  const OCR_CreateOptions* options);
+
 /**
  * 销毁引擎
  */
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_destroy(OCR_Handle h);
 
 /**
- * 设置线程数
+ * 设置线程数（det/cls/rec 的算子内线程数均设为 n，0 表示由 ORT 决定）
+ * 线程数在会话创建时生效：值变化时在下次检测开始前重建会话（耗时与加载模型相当），
+ * 同一次检测前的多次设置合并为一次重建；值不变或启用全局线程池时为空操作
  */
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_num_threads(OCR_Handle h, int n);
 
+/**
+ * 分别设置 det/cls/rec 的算子内线程数，<=0 的项保持不变；重建规则同 ocr_set_num_threads
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_model_threads(OCR_Handle h, int det, int cls, int rec);
+
+/**
+ * 设置 ORT 线程池空闲时是否自旋等待（默认 1）；0 可降低空闲时的 CPU 占用
+ * 重建规则同 ocr_set_num_threads，与线程数的变化合并为一次重建
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_thread_spinning(OCR_Handle h, int allow);
+
+/**
+ * 设置方向分类批大小：每次推理最多打包 n 个文本框，默认 6
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_cls_batch_num(OCR_Handle h, int n);
+
+/**
+ * 设置识别批大小：文本框按宽高比排序后每批最多 n 个一起推理，默认 6
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_rec_batch_num(OCR_Handle h, int n);
+
+/**
+ * 融合裁剪（默认 0）：不生成每个文本框的原尺寸裁剪图，cls/rec 直接从原图按合成的单应矩阵
+ * 一次采样到模型输入尺寸（透视校正、竖排/180° 旋转与缩放合并），减少中间图像与内存带宽
+ * 采样方式与逐步处理（双三次校正 + 双线性缩放）不同，识别结果可能有细微差异
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_fused_crop(OCR_Handle h, int enable);
+
+/**
+ * 分块检测（默认关闭）：原图（含外扩白边）任一边超过 tile_size 时，按原分辨率切成重叠的等大分块逐块检测，
+ * 再合并接缝两侧的文本框、去除重叠区内的重复框；内存占用只与分块大小有关
+ * 分块检测的图不按 short_side_len 缩小，大幅面扫描件的小字得以保留；不超过 tile_size 的图照常缩放检测
+ * @param tile_size 分块边长（原图像素，取 32 的倍数），<=0 关闭
+ * @param overlap   相邻分块重叠宽度（原图像素），应大于最大文字高度，默认 128
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_det_tiling(OCR_Handle h, int tile_size, int overlap);
+
+/**
+ * DB 快速后处理（默认 0）：一次连通域标记得到各文本区域的最小外接矩形与得分，
+ * 矩形解析外扩代替 Clipper 多边形偏移，各区域并行求框；文本框多的页面后处理耗时明显下降
+ * 得分取区域内概率均值（默认流程取轮廓多边形内均值，含孔洞），有孔洞的区域得分略高
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_fast_db_postprocess(OCR_Handle h, int enable);
+
+/**
+ * DB 框得分模式（默认 0）：0 为轮廓多边形内的概率均值（fillPoly 掩码，与 Python 一致）；
+ * 1 为轮廓外接矩形内的均值，由每帧一次的积分图 O(1) 求得，框多时更快，矩形含轮廓外像素，得分略低
+ * 启用 ocr_set_fast_db_postprocess 时不生效
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_db_rect_score(OCR_Handle h, int enable);
+
+/**
+ * DB 框得分逐行扫描（默认 0）：1 为活动边表逐行扫描轮廓多边形，直接在概率图上求和，不分配掩码、不复制 ROI；
+ * 边界像素与 fillPoly 可能相差一个像素，得分与默认略有差异
+ * 启用 ocr_set_db_rect_score 或 ocr_set_fast_db_postprocess 时不生效
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_db_scanline_score(OCR_Handle h, int enable);
+
+/**
+ * det 输入形状分桶（默认关闭）：缩放后的宽、高各自向上补齐到 sizes 中不小于它的最小边长，
+ * 补齐区域在后处理中屏蔽；det 只出现 count² 种输入形状，ORT 不再因首次出现的形状重新规划内存
+ * 设置后立即预热全部桶形状（每种推理一次），宜在加载后、处理请求前调用；边长超过最大桶时按原尺寸推理
+ * @param sizes 桶边长数组（det 输入像素，向上取整为 32 的倍数），如 {640, 960, 1280}
+ * @param count 数组长度，0 关闭
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_det_shape_buckets(OCR_Handle h, const int* sizes, int count);
+
+/**
+ * 长行分窗识别（默认关闭）：文本块缩放到 rec 输入高度（48）后宽度超过 window_width 时，
+ * 切成相互重叠的等宽窗口，与其他文本块一起组批识别，再把各窗口逐时间步的结果在重叠区中点处拼接后做 CTC 合并
+ * 表格整行等超长文本块不再生成随行长增长的超宽 rec 张量
+ * @param window_width 窗口宽度（rec 输入像素），<=0 关闭，如 640
+ * @param overlap      相邻窗口重叠宽度（rec 输入像素，最多为窗口宽度的一半），应大于单个字符宽度，默认 96
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_rec_line_split(OCR_Handle h, int window_width, int overlap);
+
+/**
+ * 多数方向抽样（默认关闭，仅 most_angle=1 时生效）
+ * 每张图只按面积从大到小分类最多 max_samples 个文本块，每批推理后若剩余样本已无法改变投票结果则提前停止，
+ * 投票结果作用于该图所有文本块；方向一致的页面只需几次 cls 推理
+ * @param max_samples 每张图最多分类的文本块数，<=0 关闭（逐块分类后投票），如 12
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_cls_sampling(OCR_Handle h, int max_samples);
+
 /**
  * 设置预处理图像保存路径（调试用）
  * 下次 detect 时，若启用预处理，会将预处理后的图像保存到该路径
@@ -80,9 +233,9 @@ OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_preprocess_save_path(OCR_Handl
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_part_imgs_save_path(OCR_Handle h, const char* path);
 
 /**
- * 从内存图像检测
- * @param image_data BGR 或灰度数据（行优先）
- * @param width height channels (3 或 1)
+ * 从内存图像检测（直接引用调用方像素，不复制）
+ * @param image_data BGR / BGRA / 灰度数据（行优先、紧密排列）
+ * @param width height channels (1、3 或 4)
  * @param options 可为 NULL，使用默认
  * @param results 输出数组，调用方分配，至少 max_results 个；每个 block 的 text 由库分配
  * @param max_results 最多返回块数
@@ -94,11 +247,141 @@ OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect(
   const OCR_Options* options,
   OCR_TextBlock* results, int max_results);
 
+/**
+ * 从带行步长的内存图像检测：调用方缓冲区直接作为图像头使用，不复制、不做整图颜色转换，
+ * 各模型的归一化内核在写入输入张量时按 pixel_format 展开通道与交换 R/B
+ * 适合采集 SDK 的帧缓冲（行尾有对齐填充、RGB 或 BGRA 排列）
+ * @param image_data   首行首像素地址，调用期间须保持有效，库不会写入
+ * @param stride       行步长（字节），0 表示紧密排列；不得小于 width * 每像素字节数
+ * @param pixel_format OCR_PixelFormat
+ * @return 同 ocr_detect；-2 表示像素格式或步长无效
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_ex(
+  OCR_Handle h,
+  const unsigned char* image_data, int width, int height, int stride, int pixel_format,
+  const OCR_Options* options,
+  OCR_TextBlock* results, int max_results);
+
+/**
+ * 批量检测多张图：逐张检测文本框后，把所有图的裁剪块合并做批量方向分类与识别，再按图拆分结果
+ * 大量小图时识别批更满、推理调用次数更少；不复制输入像素
+ * @param images  输入图像数组
+ * @param count   图像数量
+ * @param options 可为 NULL，使用默认；对所有图生效
+ * @param results 输出数组，调用方分配 count 个；results[i] 对应 images[i]，
+ *                blocks 由库分配，需对每个元素调用 ocr_free_result；该图无效时 count 为 -1
+ * @return 0 成功，-1 参数错误，-2 处理中出错（推理异常、内存不足等），此时所有 results[i].count 为 -1
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_batch(
+  OCR_Handle h,
+  const OCR_Image* images, int count,
+  const OCR_Options* options,
+  OCR_Result* results);
+
 /**
  * 释放某次检测中由库分配的 text 指针（对 results[i].text 逐个调用或整批释放）
  */
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_free_text(char* text);
 
+/**
+ * 释放由库分配的 OCR_Result（逐个释放 text 与 blocks 数组），释放后 count 置 0
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_free_result(OCR_Result* result);
+
+/**
+ * 创建多帧流水线：det 线程与 cls/rec 线程由有界队列相连，第 N 帧识别时第 N+1 帧已在检测
+ * 结果严格按提交顺序输出；队列满时 submit 阻塞（反压），内存占用不随输入速度增长
+ * 流水线存续期间 h 只能由该流水线使用（不可再调用 ocr_detect / 设置接口），
+ * 且须先 ocr_pipeline_destroy 再 ocr_destroy(h)
+ * @param h           ocr_create 返回的句柄
+ * @param queue_depth 每个阶段队列的容量（帧数），<=0 使用默认值 4
+ * @return 流水线句柄，失败返回 NULL
+ */
+OCRDETECT_OCR_API OCR_Pipeline OCRDETECT_OCR_CALL ocr_pipeline_create(OCR_Handle h, int queue_depth);
+
+/**
+ * 停止流水线并释放；尚未取走的结果与未处理完的帧被丢弃
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_pipeline_destroy(OCR_Pipeline p);
+
+/**
+ * 提交一帧（图像数据会被复制，返回后调用方可复用缓冲区）
+ * @param image_data BGR / BGRA / 灰度数据（行优先、连续）
+ * @param width height channels (1、3 或 4)
+ * @param options  可为 NULL，使用默认
+ * @param blocking 1 队列满时等待；0 队列满时立即返回 -1
+ * @return 帧序号（从 0 递增，与 poll 的 seq 对应）；-1 队列满或流水线已停止；-2 参数错误
+ */
+OCRDETECT_OCR_API long long OCRDETECT_OCR_CALL ocr_pipeline_submit(
+  OCR_Pipeline p,
+  const unsigned char* image_data, int width, int height, int channels,
+  const OCR_Options* options, int blocking);
+
+/**
+ * 按提交顺序取出下一帧结果
+ * @param timeout_ms <0 无限等待，0 不等待
+ * @param seq    输出该结果的帧序号，可为 NULL
+ * @param result 输出结果，blocks 由库分配，需 ocr_free_result 释放；该帧处理失败时 count 为 -1
+ * @return 1 取到结果，0 超时，-1 参数错误
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_pipeline_poll(
+  OCR_Pipeline p, int timeout_ms, long long* seq, OCR_Result* result);
+
+/**
+ * 流式检测的结果回调：每个带处理完成时调用一次，blocks 为归属该带的文本块（整图坐标）
+ * blocks 及其 text 仅在回调期间有效，由库释放
+ */
+typedef void (OCRDETECT_OCR_CALL *OCR_BlockCallback)(void* user, const OCR_TextBlock* blocks, int count);
+
+/**
+ * 流式检测的行读取回调：向 dst 写入至多 max_rows 行（行步长 stride 字节，像素格式同 ocr_stream_create）
+ * @return 实际写入的行数，0 表示图像结束，<0 表示出错
+ */
+typedef int (OCRDETECT_OCR_CALL *OCR_RowReader)(void* user, unsigned char* dst, int stride, int max_rows);
+
+/**
+ * 创建流式分带检测：图像按行送入，攒满 band_height 行即检测并识别该带，相邻带重叠 overlap 行，
+ * 结果按带通过 callback 增量输出；每个文本框只归属上边界所在的带，跨带边界的框只输出一次
+ * 内存只保留一个带的像素，适合 1080x30000 一类的长截图，无需整图解码
+ * 存续期间 h 只能由该流对象使用，须先 ocr_stream_destroy 再 ocr_destroy(h)
+ * 流式检测不缩放整图，options->short_side_len 作用于每个带（0 表示不缩放，适合长图）
+ * @param width        图像宽度
+ * @param pixel_format OCR_PixelFormat
+ * @param band_height  带高（行），<=0 使用默认值 2048
+ * @param overlap      相邻带重叠行数，应大于最大文字高度，最多为带高的一半；<0 使用默认值 128
+ * @param options      可为 NULL，使用默认
+ * @param callback     结果回调，不可为 NULL
+ * @return 流句柄，失败返回 NULL
+ */
+OCRDETECT_OCR_API OCR_Stream OCRDETECT_OCR_CALL ocr_stream_create(
+  OCR_Handle h, int width, int pixel_format, int band_height, int overlap,
+  const OCR_Options* options, OCR_BlockCallback callback, void* user);
+
+/**
+ * 送入若干行（宽度与像素格式同 ocr_stream_create），返回后调用方可复用缓冲区；攒满一个带时当场检测并回调
+ * @param stride 行步长（字节），0 表示紧密排列
+ * @return 0 成功，-1 参数错误，-2 检测出错
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_push(
+  OCR_Stream s, const unsigned char* data, int rows, int stride);
+
+/**
+ * 由 reader 把行直接读进带缓冲区，直到 reader 返回 0（之后仍需调用 ocr_stream_finish）
+ * @return 0 成功，-1 参数错误或 reader 出错，-2 检测出错
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_read(OCR_Stream s, OCR_RowReader reader, void* user);
+
+/**
+ * 图像结束：检测剩余的行并输出最后一个带，之后不可再送入
+ * @return 0 成功，-1 参数错误，-2 检测出错
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_finish(OCR_Stream s);
+
+/**
+ * 释放流对象（未 finish 时丢弃剩余的行）
+ */
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_stream_destroy(OCR_Stream s);
+
 #ifdef __cplusplus
 }
 #endif
@@ -120,7 +403,7 @@ struct OCR_TextBlockCpp {
 /**
  * 直接从 cv::Mat 检测（与 OcrService 中 ocr_engine_->detect() 调用方式一致）
  * @param h       ocr_create 返回的句柄
- * @param image   BGR 格式的 cv::Mat（直接传引用，零拷贝）
+ * @param image   BGR / BGRA / 灰度 cv::Mat（可为 ROI，直接传引用，零拷贝）
  * @param options 可为 NULL，使用默认参数
  * @param out     输出的文本块列表
  * @return        检测到的文本块数量，<0 表示错误
@@ -131,6 +414,27 @@ OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_mat(
   const OCR_Options* options,
   std::vector<OCR_TextBlockCpp>& out);
 
+/**
+ * 批量检测多张 cv::Mat（同 ocr_detect_batch），out[i] 为 images[i] 的文本块列表
+ * @return 0 成功，<0 错误
+ */
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_mat_batch(
+  OCR_Handle h,
+  const std::vector<cv::Mat>& images,
+  const OCR_Options* options,
+  std::vector<std::vector<OCR_TextBlockCpp>>& out);
+
+/**
+ * 向流水线提交 cv::Mat（不复制像素，流水线持有其引用计数）
+ * 处理完成前调用方不可改写该图像的像素；复用采集缓冲区时请先 clone 或使用 ocr_pipeline_submit
+ * @return 同 ocr_pipeline_submit
+ */
+OCRDETECT_OCR_API long long OCRDETECT_OCR_CALL ocr_pipeline_submit_mat(
+  OCR_Pipeline p,
+  const cv::Mat& image,
+  const OCR_Options* options,
+  int blocking);
+
 #endif /* __cplusplus */
 
 #endif /* OCRDETECT_OCR_API_H */
@@ -1,51 +1,23 @@
 #include "AngleNet.h"
 #include "OcrUtils.h"
-#include <numeric>
+#include <algorithm>
 
 AngleNet::AngleNet() {}
 
-AngleNet::~AngleNet() {
-    delete session;
-    free(inputName);
-    free(outputName);
-}
+AngleNet::~AngleNet() {}
 
-void AngleNet::setNumThread(int numOfThread) {
-    numThread = numOfThread;
-    //===session options===
-    // Sets the number of threads used to parallelize the execution within nodes
-    // A value of 0 means ORT will pick a default
-    //sessionOptions.SetIntraOpNumThreads(numThread);
-    //set OMP_NUM_THREADS=16
-
-    // Sets the number of threads used to parallelize the execution of the graph (across nodes)
-    // If sequential execution is enabled this value is ignored
-    // A value of 0 means ORT will pick a default
-    sessionOptions.SetInterOpNumThreads(numThread);
-
-    // Sets graph optimization level
-    // ORT_DISABLE_ALL -> To disable all optimizations
-    // ORT_ENABLE_BASIC -> To enable basic optimizations (Such as redundant node removals)
-    // ORT_ENABLE_EXTENDED -> To enable extended optimizations (Includes level 1 + more complex optimizations like node fusions)
-    // ORT_ENABLE_ALL -> To Enable All possible opitmizations
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+void AngleNet::initModel(const std::string &pathStr) {
+    loadSession(pathStr);
 }
 
-void AngleNet::initModel(const std::string &pathStr) {
-#ifdef _WIN32
-    std::wstring anglePath = strToWstr(pathStr);
-    session = new Ort::Session(env, anglePath.c_str(), sessionOptions);
-#else
-    session = new Ort::Session(env, pathStr.c_str(), sessionOptions);
-#endif
-    getInputName(session,inputName);
-    getOutputName(session,outputName);
+void AngleNet::setBatchSize(int size) {
+    batchSize = size < 1 ? 1 : size;
 }
 
-Angle scoreToAngle(const std::vector<float> &outputData) {
+Angle scoreToAngle(const float *outputData, int count) {
     int maxIndex = 0;
     float maxScore = -1000.0f;
-    for (int i = 0; i < outputData.size(); i++) {
+    for (int i = 0; i < count; i++) {
         if (i == 0)maxScore = outputData[i];
         else if (outputData[i] > maxScore) {
             maxScore = outputData[i];
@@ -55,52 +27,150 @@ Angle scoreToAngle(const std::vector<float> &outputData) {
     return {maxIndex, maxScore};
 }
 
-Angle AngleNet::getAngle(cv::Mat &src) {
-
-    std::vector<float> inputTensorValues = substractMeanNormalize(src, meanValues, normValues);
-
-    std::array<int64_t, 4> inputShape{1, src.channels(), src.rows, src.cols};
+std::vector<Angle> AngleNet::getAngleBatch(int batch) {
+    std::array<int64_t, 4> inputShape = imageShape(batch, dstHeight, dstWidth);
+    const float *floatArray = run(inputShape, outputShape);
 
-    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+    // 输出 [N, numClasses]，逐行取 argmax
+    int numClasses = (int) outputShape.back();
 
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memoryInfo, inputTensorValues.data(),
-                                                             inputTensorValues.size(), inputShape.data(),
-                                                             inputShape.size());
-    assert(inputTensor.IsTensor());
-
-    auto outputTensor = session->Run(Ort::RunOptions{nullptr}, &inputName, &inputTensor, 1, &outputName, 1);
+    std::vector<Angle> angles(batch);
+    for (int i = 0; i < batch; ++i) {
+        angles[i] = scoreToAngle(floatArray + (size_t) i * numClasses, numClasses);
+    }
+    return angles;
+}
 
-    assert(outputTensor.size() == 1 && outputTensor.front().IsTensor());
+void AngleNet::classifyBatch(const CropSource &crops, const int *indices, int count, const char *path,
+                             const char *imgName, bool swapRB, std::vector<Angle> &angles) {
+    // 将多个裁剪块打包为 [N,3,H,W] 一次推理，固定 batch 的模型不足部分补 0
+    int tensorBatch = modelBatch > 0 ? modelBatch : count;
+    size_t imgSize = (size_t) 3 * dstHeight * dstWidth;
+    double startAngle = getCurrentTime();
+    // 工作区输入缓冲区跨批次复用，只清零本批用到的部分（原始字节输入填均值色，即归一化后的 0）
+    float *inputData = nullptr;
+    unsigned char *inputRaw = nullptr;
+    if (rawInput) {
+        inputRaw = inputBytes(tensorBatch * imgSize);
+        cv::Mat(tensorBatch * dstHeight, dstWidth, CV_8UC3, inputRaw).setTo(meanPixelBgr(meanValues));
+    } else {
+        inputData = inputBuffer(tensorBatch * imgSize);
+        std::fill(inputData, inputData + tensorBatch * imgSize, 0.f);
+    }
+    for (int k = 0; k < count; ++k) {
+        int i = indices[k];
+        // 与 adjustTargetImg 一致：按高度等比缩放，超出 dstWidth 的部分截掉，不足部分为白色；
+        // 缩放结果直接归一化写入张量，白色填充直接写归一化后的值，不再拼接画布
+        cv::Size cropSize = crops.cropSize(i);
+        float scale = (float) dstHeight / (float) cropSize.height;
+        int angleWidth = (std::max)(1, int((float) cropSize.width * scale));
+        crops.render(i, cv::Size(angleWidth, dstHeight), angleImg);
+        int validWidth = (std::min)(angleWidth, dstWidth);
+        cv::Mat valid = angleImg(cv::Rect(0, 0, validWidth, dstHeight));
+        if (rawInput) {
+            unsigned char *slot = inputRaw + k * imgSize;
+            if (validWidth < dstWidth)
+                cv::Mat(dstHeight, dstWidth, CV_8UC3, slot).setTo(cv::Scalar::all(255));
+            packToTensorBytes(valid, slot, dstWidth, swapRB);
+        } else {
+            float *slot = inputData + k * imgSize;
+            for (int c = 0; c < 3 && validWidth < dstWidth; ++c) {
+                float white = (255.f - meanValues[c]) * normValues[c];
+                for (int y = 0; y < dstHeight; ++y) {
+                    float *row = slot + ((size_t) c * dstHeight + y) * dstWidth;
+                    std::fill(row + validWidth, row + dstWidth, white);
+                }
+            }
+            normalizeToTensor(valid, slot, dstWidth, dstHeight, meanValues, normValues, swapRB);
+        }
 
-    std::vector<int64_t> outputShape = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape();
+        //OutPut AngleImg
+        if (isOutputAngleImg) {
+            std::string angleImgFile = getDebugImgFilePath(path, imgName, i, "-angle-");
+            saveImg(angleImg, angleImgFile.c_str());
+        }
+    }
+    std::vector<Angle> batchAngles = getAngleBatch(tensorBatch);
+    double endAngle = getCurrentTime();
+    double perAngleTime = (endAngle - startAngle) / count;
+    for (int k = 0; k < count; ++k) {
+        angles[indices[k]] = batchAngles[k];
+        angles[indices[k]].time = perAngleTime;
+    }
+}
 
-    int64_t outputCount = std::accumulate(outputShape.begin(), outputShape.end(), 1,
-                                          std::multiplies<int64_t>());
+void AngleNet::sampleMostAngle(const CropSource &crops, int begin, int end, const char *path,
+                               const char *imgName, bool swapRB, std::vector<Angle> &angles) {
+    // 候选为非空裁剪块，按面积从大到小：大块文字多，方向判断更可靠
+    std::vector<int> order;
+    for (int i = begin; i < end; ++i) {
+        if (!crops.empty(i)) order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&crops](int a, int b) {
+        return crops.cropSize(a).area() > crops.cropSize(b).area();
+    });
+
+    // 投票规则与 voteMostAngle 一致：180° 票数不少于一半时取 1
+    // 每批之后检查剩余抽样全部投给任一方向时结果是否改变，不改变即已确定，后续样本不再推理
+    int budget = (std::min)(sampleNum, (int) order.size());
+    int batch = modelBatch > 0 ? modelBatch : batchSize;
+    int sampled = 0;
+    int votes = 0;  // index 为 1 的票数
+    while (sampled < budget) {
+        int count = (std::min)(batch, budget - sampled);
+        classifyBatch(crops, order.data() + sampled, count, path, imgName, swapRB, angles);
+        for (int k = sampled; k < sampled + count; ++k) {
+            if (angles[order[k]].index == 1) ++votes;
+        }
+        sampled += count;
+        int remaining = budget - sampled;
+        if (2 * votes >= sampled + remaining || 2 * votes + remaining < sampled) break;
+    }
 
-    float *floatArray = outputTensor.front().GetTensorMutableData<float>();
-    std::vector<float> outputData(floatArray, floatArray + outputCount);
-    return scoreToAngle(outputData);
+    int mostAngleIndex = (sampled > 0 && 2 * votes >= sampled) ? 1 : 0;
+    double scoreSum = 0;
+    int scoreCount = 0;
+    for (int k = 0; k < sampled; ++k) {
+        if (angles[order[k]].index != mostAngleIndex) continue;
+        scoreSum += angles[order[k]].score;
+        ++scoreCount;
+    }
+    float mostAngleScore = scoreCount > 0 ? (float) (scoreSum / scoreCount) : 0.f;
+
+    // 已分类的块保留自身得分与耗时，其余非空块直接采用投票结果；空块不参与，保持 index -1
+    std::vector<bool> classified(end - begin, false);
+    for (int k = 0; k < sampled; ++k) classified[order[k] - begin] = true;
+    for (int i = begin; i < end; ++i) {
+        if (crops.empty(i)) {
+            angles[i] = Angle{-1, 0.f, 0};
+            continue;
+        }
+        if (!classified[i - begin]) angles[i] = Angle{mostAngleIndex, mostAngleScore, 0};
+        angles[i].index = mostAngleIndex;
+    }
 }
 
-std::vector<Angle> AngleNet::getAngles(std::vector<cv::Mat> &partImgs, const char *path,
-                                       const char *imgName, bool doAngle, bool mostAngle) {
-    int size = partImgs.size();
+std::vector<Angle> AngleNet::getAngles(const CropSource &crops, const char *path,
+                                       const char *imgName, bool doAngle, bool mostAngle, bool swapRB) {
+    int size = crops.size();
     std::vector<Angle> angles(size);
+    if (doAngle && mostAngle && sampleNum > 0) {
+        sampleMostAngle(crops, 0, size, path, imgName, swapRB, angles);
+        return angles;
+    }
     if (doAngle) {
+        // 空块（退化框）不推理，给中性结果 index -1，不参与投票
+        std::vector<int> indices;
+        indices.reserve(size);
         for (int i = 0; i < size; ++i) {
-            double startAngle = getCurrentTime();
-            auto angleImg = adjustTargetImg(partImgs[i], dstWidth, dstHeight);
-            Angle angle = getAngle(angleImg);
-            double endAngle = getCurrentTime();
-            angle.time = endAngle - startAngle;
-
-            angles[i] = angle;
-
-            //OutPut AngleImg
-            if (isOutputAngleImg) {
-                std::string angleImgFile = getDebugImgFilePath(path, imgName, i, "-angle-");
-                saveImg(angleImg, angleImgFile.c_str());
-            }
+            if (crops.empty(i)) angles[i] = Angle{-1, 0.f, 0};
+            else indices.push_back(i);
+        }
+        int count = (int) indices.size();
+        int batch = modelBatch > 0 ? modelBatch : batchSize;
+        for (int begin = 0; begin < count; begin += batch) {
+            int batchCount = (std::min)(batch, count - begin);
+            classifyBatch(crops, indices.data() + begin, batchCount, path, imgName, swapRB, angles);
         }
     } else {
         for (int i = 0; i < size; ++i) {
@@ -109,21 +179,50 @@ std::vector<Angle> AngleNet::getAngles(std::vector<cv::Mat> &partImgs, const cha
     }
     //Most Possible AngleIndex
     if (doAngle && mostAngle) {
-        auto angleIndexes = getAngleIndexes(angles);
-        double sum = std::accumulate(angleIndexes.begin(), angleIndexes.end(), 0.0);
-        double halfPercent = angles.size() / 2.0f;
-        int mostAngleIndex;
-        if (sum < halfPercent) {//all angle set to 0
-            mostAngleIndex = 0;
-        } else {//all angle set to 1
-            mostAngleIndex = 1;
-        }
-        for (int i = 0; i < angles.size(); ++i) {
-            Angle angle = angles[i];
-            angle.index = mostAngleIndex;
-            angles.at(i) = angle;
-        }
+        voteMostAngle(angles, 0, angles.size());
     }
 
     return angles;
+}
+
+std::vector<Angle> AngleNet::getAngles(const CropSource &crops, const std::vector<size_t> &offsets,
+                                       bool doAngle, bool mostAngle, bool swapRB) {
+    size_t imageCount = offsets.empty() ? 0 : offsets.size() - 1;
+    if (!(doAngle && mostAngle && sampleNum > 0)) {
+        std::vector<Angle> angles = getAngles(crops, NULL, NULL, doAngle, false, swapRB);
+        if (doAngle && mostAngle) {
+            for (size_t i = 0; i < imageCount; ++i) {
+                voteMostAngle(angles, offsets[i], offsets[i + 1]);
+            }
+        }
+        return angles;
+    }
+    // 抽样按图进行：每张图的样本单独组批，样本数少，合并组批的收益可以忽略
+    std::vector<Angle> angles(crops.size());
+    for (size_t i = 0; i < imageCount; ++i) {
+        sampleMostAngle(crops, (int) offsets[i], (int) offsets[i + 1], NULL, NULL, swapRB, angles);
+    }
+    return angles;
+}
+
+void AngleNet::voteMostAngle(std::vector<Angle> &angles, size_t begin, size_t end) {
+    // index 为 -1 的块（空块或未分类）不计票，也不被改写
+    double sum = 0;
+    size_t voteCount = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (angles[i].index < 0) continue;
+        sum += angles[i].index;
+        ++voteCount;
+    }
+    if (voteCount == 0) return;
+    double halfPercent = voteCount / 2.0f;
+    int mostAngleIndex;
+    if (sum < halfPercent) {//all angle set to 0
+        mostAngleIndex = 0;
+    } else {//all angle set to 1
+        mostAngleIndex = 1;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        if (angles[i].index >= 0) angles[i].index = mostAngleIndex;
+    }
 }
\ No newline at end of file
@@ -2,39 +2,81 @@
 #define __OCR_ANGLENET_H__
 
 #include "OcrStruct.h"
-#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+#include "OnnxNet.h"
+#include "CropSource.h"
 #include <opencv2/opencv.hpp>
 
-class AngleNet {
+class AngleNet : public OnnxNet {
 public:
     AngleNet();
 
     ~AngleNet();
 
-    void setNumThread(int numOfThread);
-
     void initModel(const std::string &pathStr);
 
-    std::vector<Angle> getAngles(std::vector<cv::Mat> &partImgs, const char *path,
-                                 const char *imgName, bool doAngle, bool mostAngle);
+    /**
+     * @brief 设置方向分类的批大小（每次 session->Run 最多打包的裁剪块数量）
+     * 模型 batch 维为固定值时以模型为准
+     */
+    void setBatchSize(int size);
+
+    /**
+     * @brief 多数方向抽样（默认 0，关闭）：mostAngle 时只按面积从大到小分类最多 maxSamples 个裁剪块，
+     * 每批推理后若剩余抽样已无法改变投票结果则提前停止，投票结果作用于所有裁剪块
+     * 未分类的裁剪块 score 取与结果一致的样本得分均值，time 为 0；mostAngle 关闭时不生效
+     * @param maxSamples 每张图最多分类的裁剪块数，<=0 关闭（逐块分类后投票）
+     */
+    void setMostAngleSampling(int maxSamples) { sampleNum = maxSamples > 0 ? maxSamples : 0; }
+
+    /**
+     * 空块（退化框）不推理，结果为 index -1、score 0，不参与 mostAngle 投票
+     * @param crops  文本块来源（已裁剪的 Mat 或融合裁剪）
+     * @param swapRB 文本块为 BGR 顺序时为 true
+     */
+    std::vector<Angle> getAngles(const CropSource &crops, const char *path,
+                                 const char *imgName, bool doAngle, bool mostAngle, bool swapRB);
+
+    /**
+     * @brief 多数投票：把 [begin, end) 内的角度统一为占多数的方向（mostAngle 模式）
+     * index 为 -1 的空块不计票，保持不变
+     * 多张图的裁剪块合并分类时按图分段调用，每张图单独投票
+     */
+    static void voteMostAngle(std::vector<Angle> &angles, size_t begin, size_t end);
+
+    /**
+     * @brief 多张图的裁剪块合并分类，mostAngle 时每张图 [offsets[i], offsets[i+1]) 单独投票（或抽样投票）
+     */
+    std::vector<Angle> getAngles(const CropSource &crops, const std::vector<size_t> &offsets,
+                                 bool doAngle, bool mostAngle, bool swapRB);
 
 private:
     bool isOutputAngleImg = false;
 
-    Ort::Session *session;
-    Ort::Env env = Ort::Env(ORT_LOGGING_LEVEL_ERROR, "AngleNet");
-    Ort::SessionOptions sessionOptions = Ort::SessionOptions();
-    int numThread = 0;
-
-    char *inputName;
-    char *outputName;
+    int batchSize = 6;
+    int sampleNum = 0;
 
     const float meanValues[3] = {127.5, 127.5, 127.5};
     const float normValues[3] = {1.0 / 127.5, 1.0 / 127.5, 1.0 / 127.5};
     const int dstWidth = 192;
     const int dstHeight = 48;  // PPOCRv4 使用 48 像素高度
 
-    Angle getAngle(cv::Mat &src);
+    // 跨调用复用的缓冲区
+    cv::Mat angleImg;
+    std::vector<int64_t> outputShape;
+
+    /** @brief 对工作区输入缓冲区中的 [batch,3,H,W] 张量推理 */
+    std::vector<Angle> getAngleBatch(int batch);
+
+    /**
+     * @brief 把 indices 指定的 count 个非空裁剪块（count 不超过批大小）打包为一个张量推理，结果写入 angles 对应位置
+     * 单个裁剪块耗时按批内平均分摊
+     */
+    void classifyBatch(const CropSource &crops, const int *indices, int count, const char *path,
+                       const char *imgName, bool swapRB, std::vector<Angle> &angles);
+
+    /** @brief 对 [begin, end) 抽样分类并投票，结果写入 angles[begin, end) */
+    void sampleMostAngle(const CropSource &crops, int begin, int end, const char *path,
+                         const char *imgName, bool swapRB, std::vector<Angle> &angles);
 };
 
 
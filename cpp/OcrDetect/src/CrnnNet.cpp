@@ -1,185 +1,164 @@
 #include "CrnnNet.h"
 #include "OcrUtils.h"
+#include "OcrKernels.h"
+#include <algorithm>
+#include <cfloat>
 #include <fstream>
-#include <numeric>
 
 CrnnNet::CrnnNet() {}
 
-CrnnNet::~CrnnNet() {
-    delete session;
-    free(inputName);
-    free(outputName);
-}
-
-void CrnnNet::setNumThread(int numOfThread) {
-    numThread = numOfThread;
-    //===session options===
-    // Sets the number of threads used to parallelize the execution within nodes
-    // A value of 0 means ORT will pick a default
-    //sessionOptions.SetIntraOpNumThreads(numThread);
-    //set OMP_NUM_THREADS=16
-
-    // Sets the number of threads used to parallelize the execution of the graph (across nodes)
-    // If sequential execution is enabled this value is ignored
-    // A value of 0 means ORT will pick a default
-    sessionOptions.SetInterOpNumThreads(numThread);
-
-    // Sets graph optimization level
-    // ORT_DISABLE_ALL -> To disable all optimizations
-    // ORT_ENABLE_BASIC -> To enable basic optimizations (Such as redundant node removals)
-    // ORT_ENABLE_EXTENDED -> To enable extended optimizations (Includes level 1 + more complex optimizations like node fusions)
-    // ORT_ENABLE_ALL -> To Enable All possible opitmizations
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
-}
+CrnnNet::~CrnnNet() {}
 
 void CrnnNet::initModel(const std::string &pathStr, const std::string &keysPath) {
-#ifdef _WIN32
-    std::wstring crnnPath = strToWstr(pathStr);
-    session = new Ort::Session(env, crnnPath.c_str(), sessionOptions);
-#else
-    session = new Ort::Session(env, pathStr.c_str(), sessionOptions);
-#endif
-    getInputName(session, inputName);
-    getOutputName(session, outputName);
+    loadSession(pathStr);
 
     //load keys
     std::ifstream in(keysPath.c_str());
     std::string line;
+    keyChars.clear();
+    keyOffsets.assign(1, 0);
     if (in) {
         while (getline(in, line)) {// line中不包括每行的换行符
             // 去除可能的 \r (Windows 换行符兼容)
             if (!line.empty() && line.back() == '\r') {
                 line.pop_back();
             }
-            keys.push_back(line);
+            keyChars.append(line);
+            keyOffsets.push_back((int) keyChars.size());
         }
     } else {
         fprintf(stderr, "keys file not found: %s\n", keysPath.c_str());
         return;
     }
-    keys.push_back(" ");
-    if (keys.empty()) {
+    if (keyOffsets.size() == 1) {
         fprintf(stderr, "Error: keys file is empty or failed to load\n");
     }
+    keyChars.append(" ");
+    keyOffsets.push_back((int) keyChars.size());
+}
 
+void CrnnNet::setBatchSize(int size) {
+    batchSize = size < 1 ? 1 : size;
 }
 
-template<class ForwardIterator>
-inline static size_t argmax(ForwardIterator first, ForwardIterator last) {
-    return std::distance(first, std::max_element(first, last));
+void CrnnNet::setLongLineSplit(int windowWidth, int overlap) {
+    splitWidth = windowWidth <= 0 ? 0 : (std::max)(windowWidth, dstHeight);
+    splitOverlap = (std::min)((std::max)(overlap, 0), splitWidth / 2);
 }
 
-TextLine CrnnNet::scoreToTextLine(const std::vector<float> &outputData, int h, int w) {
-    int keySize = keys.size();
-    std::string strRes;
+void CrnnNet::argmaxSteps(const float *outputData, int h, int w, StepArgmax &steps) const {
+    // PPOCRv4 模型输出已经是 softmax 后的概率值
+    // 直接找最大值及其索引，不需要再做 softmax
+    // 这与 Python 版本的处理方式一致：preds_prob = preds.max(axis=2)
+    steps.indices.resize(h);
+    steps.scores.resize(h);
+    for (int i = 0; i < h; i++) {
+        steps.indices[i] = argmaxFloats(outputData + (size_t) i * w, w, &steps.scores[i]);
+    }
+}
+
+TextLine CrnnNet::collapseSteps(const std::vector<int> &indices, const std::vector<float> &stepScores) const {
+    // 字典有 keySize 个字符，对应类别 1 到 keySize；类别 0 为 blank
+    int keySize = (int) keyOffsets.size() - 1;
     std::vector<float> scores;
+    std::vector<int> kept;
     int lastIndex = 0;
-    int maxIndex;
-    float maxValue;
+    size_t textLength = 0;
 
-    for (int i = 0; i < h; i++) {
-        maxIndex = 0;
-        maxValue = -1000.f;
-        
-        // PPOCRv4 模型输出已经是 softmax 后的概率值
-        // 直接找最大值及其索引，不需要再做 softmax
-        // 这与 Python 版本的处理方式一致：preds_prob = preds.max(axis=2)
-        for (int j = 0; j < w; j++) {
-            float value = outputData[i * w + j];
-            if (value > maxValue) {
-                maxValue = value;
-                maxIndex = j;
-            }
-        }
-        
-        // PPOCRv4: index 0 是 blank，字典字符从 index 1 开始
-        // 字典有 keySize 个字符，对应 index 1 到 keySize
-        // 修复边界条件: maxIndex <= keySize (而不是 < keySize)
+    for (size_t i = 0; i < indices.size(); i++) {
+        int maxIndex = indices[i];
         if (maxIndex > 0 && maxIndex <= keySize && (!(i > 0 && maxIndex == lastIndex))) {
-            scores.emplace_back(maxValue);
-            strRes.append(keys[maxIndex - 1]);
+            scores.emplace_back(stepScores[i]);
+            kept.push_back(maxIndex);
+            textLength += keyOffsets[maxIndex] - keyOffsets[maxIndex - 1];
         }
         lastIndex = maxIndex;
     }
+
+    // 先求总长度，一次分配后按偏移表复制各字符的 UTF-8 字节
+    std::string strRes;
+    strRes.reserve(textLength);
+    for (int index : kept) {
+        strRes.append(keyChars, keyOffsets[index - 1], keyOffsets[index] - keyOffsets[index - 1]);
+    }
     return {strRes, scores};
 }
 
-TextLine CrnnNet::getTextLine(const cv::Mat &src) {
-    // ===== 完全复现 Python OnnxOCR predict_rec.py 中的 resize_norm_img =====
+std::vector<CrnnNet::StepArgmax> CrnnNet::getStepBatch(const CropSource &crops, const std::vector<int> &indices,
+                                                       bool swapRB) {
+    // ===== 复现 Python OnnxOCR predict_rec.py 的批处理 resize_norm_img =====
     // Python: rec_image_shape = [3, 48, 320], rec_algorithm = 'SVTR_LCNet'
-    int imgC = 3, imgH = dstHeight, imgW = 320;
-
-    int h = src.rows, w = src.cols;
-    float ratio = (float)w / (float)h;
-    // Python: max_wh_ratio = max(imgW/imgH, w/h)
-    float max_wh_ratio = (float)imgW / (float)imgH;
-    if (ratio > max_wh_ratio) max_wh_ratio = ratio;
-    // Python: imgW = int(imgH * max_wh_ratio)
-    imgW = (int)(imgH * max_wh_ratio);
+    // 同一批内的所有裁剪块按批内最大宽高比统一填充到相同的 imgW
+    int imgC = 3, imgH = dstHeight, imgW = dstWidth;
+    int count = (int) indices.size();
+    int tensorBatch = modelBatch > 0 ? modelBatch : count;
 
-    // Python: resized_w = int(math.ceil(imgH * ratio))，但不超过 imgW
-    int resized_w;
-    if ((int)ceil(imgH * ratio) > imgW) {
-        resized_w = imgW;
-    } else {
-        resized_w = (int)ceil(imgH * ratio);
+    // Python: max_wh_ratio = max(imgW/imgH, max(w/h for img in batch))
+    float max_wh_ratio = (float) imgW / (float) imgH;
+    for (int i = 0; i < count; ++i) {
+        cv::Size cropSize = crops.cropSize(indices[i]);
+        float ratio = (float) cropSize.width / (float) cropSize.height;
+        if (ratio > max_wh_ratio) max_wh_ratio = ratio;
     }
-
-    cv::Mat srcResize;
-    cv::resize(src, srcResize, cv::Size(resized_w, imgH));
-
-    // Python 归一化:
-    // resized_image = resized_image.astype('float32')
-    // resized_image = resized_image.transpose((2, 0, 1)) / 255
-    // resized_image -= 0.5
-    // resized_image /= 0.5
-    // 等价于: (pixel / 255.0 - 0.5) / 0.5 = pixel / 127.5 - 1.0
-    // 与 substractMeanNormalize(meanValues={127.5}, normValues={1/127.5}) 完全一致
+    // Python: imgW = int(imgH * max_wh_ratio)
+    // 再向上取整到 widthAlign 的倍数，多出的宽度与批内较窄文本块一样右侧补 0：
+    // 宽高比连续变化时张量宽度只落在少数几个桶上，稳态推理复用已绑定的工作区，不再每批遇到新形状
+    imgW = (int) (imgH * max_wh_ratio);
+    imgW = (imgW + widthAlign - 1) / widthAlign * widthAlign;
 
     // Python 零填充: padding_im = np.zeros((imgC, imgH, imgW)); padding_im[:,:,0:resized_w] = resized_image
     // CHW 格式，先对 resize 后的图像做归一化，然后右侧用 0.0 填充到 imgW
-    size_t imageSize_resized = resized_w * imgH;
-    size_t imageSize_padded = imgW * imgH;
-    size_t numChannels = srcResize.channels();
-
-    std::vector<float> inputTensorValues(numChannels * imageSize_padded, 0.0f);
-    // 填充有效区域 (CHW 格式)
-    for (int y = 0; y < imgH; y++) {
-        for (int x = 0; x < resized_w; x++) {
-            int pid = y * resized_w + x;
-            for (size_t ch = 0; ch < numChannels; ch++) {
-                float pixel = (float)srcResize.data[(y * resized_w + x) * numChannels + ch];
-                float normalized = pixel / 127.5f - 1.0f;
-                inputTensorValues[ch * imageSize_padded + y * imgW + x] = normalized;
-            }
-        }
+    size_t imageSize_padded = (size_t) imgW * imgH;
+    size_t imageSize_batch = imgC * imageSize_padded;
+    // 工作区输入缓冲区跨批次复用，只清零本批用到的部分
+    // 原始字节输入填均值色 128（归一化后为 1/255 ≈ 0.004，与 0.0 的差异可忽略）
+    float *inputData = nullptr;
+    unsigned char *inputRaw = nullptr;
+    if (rawInput) {
+        inputRaw = inputBytes(tensorBatch * imageSize_batch);
+        cv::Mat(tensorBatch * imgH, imgW, CV_8UC3, inputRaw).setTo(meanPixelBgr(meanValues));
+    } else {
+        inputData = inputBuffer(tensorBatch * imageSize_batch);
+        std::fill(inputData, inputData + tensorBatch * imageSize_batch, 0.0f);
     }
-    // 右侧填充区域保持 0.0f（已在 vector 初始化时设为 0）
 
-    std::array<int64_t, 4> inputShape{1, (int64_t)numChannels, imgH, imgW};
-
-    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memoryInfo, inputTensorValues.data(),
-                                                             inputTensorValues.size(), inputShape.data(),
-                                                             inputShape.size());
-    assert(inputTensor.IsTensor());
-
-    auto outputTensor = session->Run(Ort::RunOptions{nullptr}, &inputName, &inputTensor, 1, &outputName, 1);
+    for (int i = 0; i < count; ++i) {
+        cv::Size cropSize = crops.cropSize(indices[i]);
+        float ratio = (float) cropSize.width / (float) cropSize.height;
+        // Python: resized_w = int(math.ceil(imgH * ratio))，但不超过 imgW
+        int resized_w;
+        if ((int) ceil(imgH * ratio) > imgW) {
+            resized_w = imgW;
+        } else {
+            resized_w = (int) ceil(imgH * ratio);
+        }
 
-    assert(outputTensor.size() == 1 && outputTensor.front().IsTensor());
+        // 已裁剪的 Mat 在此 resize；融合裁剪从原图一次采样到 imgH 高
+        crops.render(indices[i], cv::Size(resized_w, imgH), srcResize);
 
-    std::vector<int64_t> outputShape = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape();
+        // Python 归一化:
+        // resized_image = resized_image.astype('float32')
+        // resized_image = resized_image.transpose((2, 0, 1)) / 255
+        // resized_image -= 0.5
+        // resized_image /= 0.5
+        // 等价于: (pixel / 255.0 - 0.5) / 0.5 = pixel / 127.5 - 1.0
+        // 即 normalizeToTensor(meanValues={127.5}, normValues={1/127.5})
+        // 填充有效区域 (CHW 格式，BGR 输入交换为 RGB)，右侧填充区域保持 0.0f
+        if (rawInput)
+            packToTensorBytes(srcResize, inputRaw + i * imageSize_batch, imgW, swapRB);
+        else
+            normalizeToTensor(srcResize, inputData + i * imageSize_batch, imgW, imgH,
+                              meanValues, normValues, swapRB);
+    }
 
-    int64_t outputCount = std::accumulate(outputShape.begin(), outputShape.end(), 1,
-                                          std::multiplies<int64_t>());
+    std::array<int64_t, 4> inputShape = imageShape(tensorBatch, imgH, imgW);
 
-    float *floatArray = outputTensor.front().GetTensorMutableData<float>();
-    std::vector<float> outputData(floatArray, floatArray + outputCount);
+    const float *floatArray = run(inputShape, outputShape);
 
+    // 批量输出为 [N, T, C]；单张时部分模型输出 [T, 1, C] 或 [T, C]
     int timeSteps, numClasses;
     if (outputShape.size() == 3) {
-        if (outputShape[1] == 1) {
+        if (tensorBatch == 1 && outputShape[1] == 1) {
             timeSteps = outputShape[0];
             numClasses = outputShape[2];
         } else {
@@ -193,25 +172,161 @@ TextLine CrnnNet::getTextLine(const cv::Mat &src) {
         timeSteps = outputShape[0];
         numClasses = outputShape[outputShape.size() - 1];
     }
-    return scoreToTextLine(outputData, timeSteps, numClasses);
+
+    // 直接读取工作区输出；批内各行相互独立，多行时并行求 argmax
+    std::vector<StepArgmax> steps(count);
+    float stride = (float) imgW / (float) timeSteps;
+    cv::parallel_for_(cv::Range(0, count), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i) {
+            argmaxSteps(floatArray + (size_t) i * timeSteps * numClasses, timeSteps, numClasses, steps[i]);
+            steps[i].stride = stride;
+        }
+    });
+    return steps;
 }
 
-std::vector<TextLine> CrnnNet::getTextLines(std::vector<cv::Mat> &partImg, const char *path, const char *imgName) {
-    int size = partImg.size();
+namespace {
+
+/**
+ * 识别单元：整个文本块，或长行按输入高度渲染后的一个水平窗口
+ * 窗口等宽，与普通文本块一样按宽高比排序、组批
+ */
+class RecUnitSource : public CropSource {
+public:
+    struct Unit {
+        int crop;
+        int x0, x1;  // 窗口在渲染行中的列范围
+        int line;    // 渲染行下标，<0 表示整个文本块
+    };
+
+    RecUnitSource(const CropSource &crops, int height) : crops(crops), height(height) {}
+
+    void addCrop(int crop) { units.push_back(Unit{crop, 0, 0, -1}); }
+
+    /** @brief 把文本块渲染为 height 高、lineWidth 宽的一行，切成重叠的等宽窗口，最后一个窗口与行尾对齐 */
+    void addWindows(int crop, int lineWidth, int windowWidth, int overlap) {
+        lines.emplace_back();
+        crops.render(crop, cv::Size(lineWidth, height), lines.back());
+        int line = (int) lines.size() - 1;
+        int step = windowWidth - overlap;
+        for (int x0 = 0;; x0 += step) {
+            if (x0 + windowWidth >= lineWidth) {
+                units.push_back(Unit{crop, lineWidth - windowWidth, lineWidth, line});
+                break;
+            }
+            units.push_back(Unit{crop, x0, x0 + windowWidth, line});
+        }
+    }
+
+    const Unit &unit(int i) const { return units[i]; }
+
+    int size() const override { return (int) units.size(); }
+
+    cv::Size cropSize(int i) const override {
+        const Unit &u = units[i];
+        return u.line < 0 ? crops.cropSize(u.crop) : cv::Size(u.x1 - u.x0, height);
+    }
+
+    void render(int i, cv::Size dstSize, cv::Mat &dst) const override {
+        const Unit &u = units[i];
+        if (u.line < 0) crops.render(u.crop, dstSize, dst);
+        else cv::resize(lines[u.line](cv::Rect(u.x0, 0, u.x1 - u.x0, height)), dst, dstSize);
+    }
+
+private:
+    const CropSource &crops;
+    int height;
+    std::vector<Unit> units;
+    std::vector<cv::Mat> lines;
+};
+
+} // namespace
+
+std::vector<TextLine> CrnnNet::getTextLines(const CropSource &crops, const char *path, const char *imgName,
+                                            bool swapRB) {
+    int size = crops.size();
     std::vector<TextLine> textLines(size);
-    for (int i = 0; i < size; ++i) {
-        //OutPut DebugImg
-        if (isOutputDebugImg) {
+
+    //OutPut DebugImg
+    if (isOutputDebugImg) {
+        for (int i = 0; i < size; ++i) {
             std::string debugImgFile = getDebugImgFilePath(path, imgName, i, "-debug-");
-            saveImg(partImg[i], debugImgFile.c_str());
+            if (crops.empty(i)) continue;
+            cv::Mat debugImg;
+            crops.render(i, crops.cropSize(i), debugImg);
+            saveImg(debugImg, debugImgFile.c_str());
         }
+    }
+
+    // 缩放到输入高度后超过窗口宽度的长行切成窗口，其余文本块整体识别
+    RecUnitSource units(crops, dstHeight);
+    for (int i = 0; i < size; ++i) {
+        if (crops.empty(i)) continue;
+        cv::Size cropSize = crops.cropSize(i);
+        int lineWidth = (int) ceil(dstHeight * (float) cropSize.width / (float) cropSize.height);
+        if (splitWidth > 0 && lineWidth > splitWidth) units.addWindows(i, lineWidth, splitWidth, splitOverlap);
+        else units.addCrop(i);
+    }
+
+    // 按宽高比升序排序，使同一批内宽度相近，减少右侧零填充
+    int unitCount = units.size();
+    std::vector<int> order(unitCount);
+    std::vector<float> ratios(unitCount, 0.f);
+    for (int i = 0; i < unitCount; ++i) {
+        cv::Size cropSize = units.cropSize(i);
+        ratios[i] = (float) cropSize.width / (float) cropSize.height;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&ratios](int a, int b) { return ratios[a] < ratios[b]; });
+
+    std::vector<StepArgmax> steps(unitCount);
+    std::vector<double> times(unitCount, 0.0);
+    int batch = modelBatch > 0 ? modelBatch : batchSize;
+    for (size_t begin = 0; begin < order.size(); begin += batch) {
+        size_t end = (std::min)(begin + batch, order.size());
+        std::vector<int> indices(order.begin() + begin, order.begin() + end);
 
-        //getTextLine
         double startCrnnTime = getCurrentTime();
-        TextLine textLine = getTextLine(partImg[i]);
+        std::vector<StepArgmax> batchSteps = getStepBatch(units, indices, swapRB);
         double endCrnnTime = getCurrentTime();
-        textLine.time = endCrnnTime - startCrnnTime;
-        textLines[i] = textLine;
+        // 单元耗时按批内平均分摊
+        double perUnitTime = (endCrnnTime - startCrnnTime) / indices.size();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            steps[indices[i]] = std::move(batchSteps[i]);
+            times[indices[i]] = perUnitTime;
+        }
+    }
+
+    // 按原始文本框顺序写回：整块直接 CTC 合并；长行的各窗口以相邻窗口重叠区的中点为界，
+    // 每个窗口只保留中心落在自己区间内的时间步，拼接后再合并（跨界的同一字符在合并时去重）
+    for (int u = 0; u < unitCount;) {
+        const RecUnitSource::Unit &first = units.unit(u);
+        int next = u + 1;
+        while (next < unitCount && units.unit(next).crop == first.crop) ++next;
+
+        double time = 0.0;
+        for (int k = u; k < next; ++k) time += times[k];
+        if (first.line < 0) {
+            textLines[first.crop] = collapseSteps(steps[u].indices, steps[u].scores);
+        } else {
+            std::vector<int> indices;
+            std::vector<float> scores;
+            for (int k = u; k < next; ++k) {
+                const RecUnitSource::Unit &window = units.unit(k);
+                float lo = k == u ? -FLT_MAX : 0.5f * (window.x0 + units.unit(k - 1).x1);
+                float hi = k + 1 == next ? FLT_MAX : 0.5f * (units.unit(k + 1).x0 + window.x1);
+                const StepArgmax &s = steps[k];
+                for (size_t t = 0; t < s.indices.size(); ++t) {
+                    float center = window.x0 + (t + 0.5f) * s.stride;
+                    if (center < lo || center >= hi) continue;
+                    indices.push_back(s.indices[t]);
+                    scores.push_back(s.scores[t]);
+                }
+            }
+            textLines[first.crop] = collapseSteps(indices, scores);
+        }
+        textLines[first.crop].time = time;
+        u = next;
     }
     return textLines;
 }
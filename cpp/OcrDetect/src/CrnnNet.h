@@ -2,41 +2,78 @@
 #define __OCR_CRNNNET_H__
 
 #include "OcrStruct.h"
-#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+#include "OnnxNet.h"
+#include "CropSource.h"
 #include <opencv2/opencv.hpp>
 
-class CrnnNet {
+class CrnnNet : public OnnxNet {
 public:
 
     CrnnNet();
 
     ~CrnnNet();
 
-    void setNumThread(int numOfThread);
-
     void initModel(const std::string &pathStr, const std::string &keysPath);
 
-    std::vector<TextLine> getTextLines(std::vector<cv::Mat> &partImg, const char *path, const char *imgName);
+    /**
+     * @brief 设置识别批大小：按宽高比排序后每批最多打包的裁剪块数量
+     * 模型 batch 维为固定值时以模型为准
+     */
+    void setBatchSize(int size);
+
+    /**
+     * @brief 长行分窗识别（默认关闭）：缩放到输入高度后宽度超过 windowWidth 的文本块切成重叠的等宽窗口，
+     * 窗口与其他文本块一起按宽高比组批识别；各窗口逐时间步的 argmax 以重叠区中点为界拼接，再做 CTC 合并
+     * rec 输入宽度不再随行长增长，长行不会单独占用一个超宽张量
+     * @param windowWidth 窗口宽度（输入像素，高 48），<=0 关闭
+     * @param overlap     相邻窗口重叠宽度（输入像素，最多为窗口宽度的一半），应大于单个字符宽度
+     */
+    void setLongLineSplit(int windowWidth, int overlap);
+
+    /**
+     * @param crops  文本块来源（已裁剪的 Mat 或融合裁剪）
+     * @param swapRB 文本块为 BGR 顺序时为 true
+     */
+    std::vector<TextLine> getTextLines(const CropSource &crops, const char *path, const char *imgName,
+                                       bool swapRB);
 
 private:
     bool isOutputDebugImg = false;
-    Ort::Session *session;
-    Ort::Env env = Ort::Env(ORT_LOGGING_LEVEL_ERROR, "CrnnNet");
-    Ort::SessionOptions sessionOptions = Ort::SessionOptions();
-    int numThread = 0;
-
-    char *inputName;
-    char *outputName;
+    int batchSize = 6;
 
     const float meanValues[3] = {127.5, 127.5, 127.5};
     const float normValues[3] = {1.0 / 127.5, 1.0 / 127.5, 1.0 / 127.5};
     const int dstHeight = 48;  // PPOCRv4 使用 48 像素高度
 
-    std::vector<std::string> keys;
+    // 扁平 UTF-8 字典：第 i 行为 keyChars[keyOffsets[i], keyOffsets[i + 1])，对应类别 i + 1（类别 0 为 blank）
+    std::string keyChars;
+    std::vector<int> keyOffsets;
+
+    const int dstWidth = 320;  // PPOCRv4 rec_image_shape = [3, 48, 320]
+    // 批宽度向上取整的步长：宽度只出现少数几种，工作区绑定与 ORT 内存规划可复用
+    const int widthAlign = 32;
+
+    // 跨调用复用的缓冲区
+    cv::Mat srcResize;
+    std::vector<int64_t> outputShape;
+
+    int splitWidth = 0;
+    int splitOverlap = 96;
+
+    /** 一行（或一个窗口）逐时间步的 argmax，stride 为每个时间步对应的输入像素宽度 */
+    struct StepArgmax {
+        std::vector<int> indices;
+        std::vector<float> scores;
+        float stride = 0.f;
+    };
+
+    /** @brief 逐时间步 SIMD argmax，只读输出，可在多个线程中同时处理不同的行 */
+    void argmaxSteps(const float *outputData, int h, int w, StepArgmax &steps) const;
 
-    TextLine scoreToTextLine(const std::vector<float> &outputData, int h, int w);
+    /** @brief CTC 贪心解码：合并重复、去除 blank 后由扁平字典拼接文本 */
+    TextLine collapseSteps(const std::vector<int> &indices, const std::vector<float> &stepScores) const;
 
-    TextLine getTextLine(const cv::Mat &src);
+    std::vector<StepArgmax> getStepBatch(const CropSource &crops, const std::vector<int> &indices, bool swapRB);
 };
 
 
@@ -0,0 +1,56 @@
+#include "CropSource.h"
+#include "OcrUtils.h"
+#include <opencv2/imgproc.hpp>
+
+void MatCropSource::render(int i, cv::Size dstSize, cv::Mat &dst) const {
+    // 尺寸相同时也复制：调用方会在循环中复用 dst，不能让它成为裁剪图的图像头
+    cv::resize(images[i], dst, dstSize);
+}
+
+void QuadCropSource::render(int i, cv::Size dstSize, cv::Mat &dst) const {
+    const TextCrop &crop = crops[i];
+    double w = crop.size.width, h = crop.size.height;
+    // 输出像素 -> 校正后文本块像素：按像素中心对齐缩放，与 cv::resize 的坐标映射一致
+    double sx = w / dstSize.width, sy = h / dstSize.height;
+    cv::Matx33d scale(sx, 0, 0.5 * sx - 0.5,
+                      0, sy, 0.5 * sy - 0.5,
+                      0, 0, 1);
+    cv::Matx33d m = crop.toSrc;
+    if (crop.rotate180) {
+        m = m * cv::Matx33d(-1, 0, w - 1,
+                            0, -1, h - 1,
+                            0, 0, 1);
+    }
+    m = m * scale;
+    // 一次采样完成透视校正、旋转与缩放；越界部分复制原图边缘
+    cv::warpPerspective(crop.src, dst, cv::Mat(m), dstSize,
+                        cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
+}
+
+TextCrop makeTextCrop(const cv::Mat &src, const std::vector<cv::Point> &box) {
+    TextCrop crop;
+    cv::Size size = getRotateCropSize(src, box);
+    if (size.empty()) return crop;
+    crop.src = src;
+
+    // 校正后像素 -> 原图像素，即 getRotateCropImage 中透视矩阵的逆
+    cv::Point2f rectPts[4] = {cv::Point2f(0.f, 0.f), cv::Point2f((float) size.width, 0.f),
+                              cv::Point2f((float) size.width, (float) size.height),
+                              cv::Point2f(0.f, (float) size.height)};
+    cv::Point2f quadPts[4];
+    for (int k = 0; k < 4; ++k) quadPts[k] = cv::Point2f((float) box[k].x, (float) box[k].y);
+    cv::Matx33d toCrop(cv::getPerspectiveTransform(rectPts, quadPts));
+
+    if (float(size.height) >= float(size.width) * 1.5) {
+        // 竖排：transpose + 垂直翻转，输出 (x, y) 取自校正图 (w - 1 - y, x)
+        cv::Matx33d vertical(0, -1, size.width - 1,
+                             1, 0, 0,
+                             0, 0, 1);
+        crop.toSrc = toCrop * vertical;
+        crop.size = cv::Size(size.height, size.width);
+    } else {
+        crop.toSrc = toCrop;
+        crop.size = size;
+    }
+    return crop;
+}
@@ -0,0 +1,70 @@
+#ifndef __OCR_CROP_SOURCE_H__
+#define __OCR_CROP_SOURCE_H__
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "OcrStruct.h"
+
+/**
+ * cls/rec 的文本块输入：按下标给出校正后文本块的尺寸，并把文本块缩放到模型输入尺寸
+ * MatCropSource 对已裁剪好的 Mat 做 resize；QuadCropSource 从原图按四边形一次透视采样（融合裁剪）
+ */
+class CropSource {
+public:
+    virtual ~CropSource() = default;
+
+    virtual int size() const = 0;
+
+    /** @brief 第 i 块校正后（竖排已转横）的尺寸，无效块返回空尺寸 */
+    virtual cv::Size cropSize(int i) const = 0;
+
+    /**
+     * @brief 把第 i 块缩放到 dstSize 写入 dst（8 位，通道数与源图一致）
+     * dst 尺寸类型不变时复用其缓冲区，循环中可反复传入同一个 Mat
+     */
+    virtual void render(int i, cv::Size dstSize, cv::Mat &dst) const = 0;
+
+    bool empty(int i) const { return cropSize(i).area() <= 0; }
+};
+
+/** 已裁剪好的文本块图像（旋转 180° 已作用在图像上） */
+class MatCropSource : public CropSource {
+public:
+    explicit MatCropSource(const std::vector<cv::Mat> &images) : images(images) {}
+
+    int size() const override { return (int) images.size(); }
+
+    cv::Size cropSize(int i) const override { return images[i].size(); }
+
+    void render(int i, cv::Size dstSize, cv::Mat &dst) const override;
+
+private:
+    const std::vector<cv::Mat> &images;
+};
+
+/**
+ * 融合裁剪：透视校正、竖排旋转、180° 旋转与缩放合成一个单应矩阵，
+ * 从原图直接采样到 cls/rec 的输入尺寸，不生成原尺寸裁剪图及其旋转/缩放副本
+ */
+class QuadCropSource : public CropSource {
+public:
+    explicit QuadCropSource(const std::vector<TextCrop> &crops) : crops(crops) {}
+
+    int size() const override { return (int) crops.size(); }
+
+    cv::Size cropSize(int i) const override { return crops[i].size; }
+
+    void render(int i, cv::Size dstSize, cv::Mat &dst) const override;
+
+private:
+    const std::vector<TextCrop> &crops;
+};
+
+/**
+ * @brief 由检测框计算融合裁剪的几何（与 getRotateCropImage 的尺寸与竖排规则一致），不读取像素
+ * @param src 外扩白边后的原图，TextCrop 共享其像素
+ */
+TextCrop makeTextCrop(const cv::Mat &src, const std::vector<cv::Point> &box);
+
+
+#endif //__OCR_CROP_SOURCE_H__
@@ -1,48 +1,75 @@
 #include "DbNet.h"
 #include "OcrUtils.h"
+#include <algorithm>
+#include <climits>
 
 DbNet::DbNet() {}
 
-DbNet::~DbNet() {
-    delete session;
-    free(inputName);
-    free(outputName);
+DbNet::~DbNet() {}
+
+void DbNet::initModel(const std::string &pathStr) {
+    loadSession(pathStr);
 }
 
-void DbNet::setNumThread(int numOfThread) {
-    numThread = numOfThread;
-    //===session options===
-    // Sets the number of threads used to parallelize the execution within nodes
-    // A value of 0 means ORT will pick a default
-    //sessionOptions.SetIntraOpNumThreads(numThread);
-    //set OMP_NUM_THREADS=16
-
-    // Sets the number of threads used to parallelize the execution of the graph (across nodes)
-    // If sequential execution is enabled this value is ignored
-    // A value of 0 means ORT will pick a default
-    sessionOptions.SetInterOpNumThreads(numThread);
-
-    // Sets graph optimization level
-    // ORT_DISABLE_ALL -> To disable all optimizations
-    // ORT_ENABLE_BASIC -> To enable basic optimizations (Such as redundant node removals)
-    // ORT_ENABLE_EXTENDED -> To enable extended optimizations (Includes level 1 + more complex optimizations like node fusions)
-    // ORT_ENABLE_ALL -> To Enable All possible opitmizations
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+bool DbNet::setShapeBuckets(const std::vector<int> &sizes) {
+    std::vector<int> buckets;
+    for (int size : sizes) {
+        if (size > 0) buckets.push_back((size + 31) / 32 * 32);
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    if (buckets == shapeBuckets) return false;
+    shapeBuckets.swap(buckets);
+    return true;
 }
 
-void DbNet::initModel(const std::string &pathStr) {
-#ifdef _WIN32
-    std::wstring dbPath = strToWstr(pathStr);
-    session = new Ort::Session(env, dbPath.c_str(), sessionOptions);
-#else
-    session = new Ort::Session(env, pathStr.c_str(), sessionOptions);
-#endif
-    getInputName(session, inputName);
-    getOutputName(session, outputName);
+int DbNet::bucketSize(int len) const {
+    auto it = std::lower_bound(shapeBuckets.begin(), shapeBuckets.end(), len);
+    return it == shapeBuckets.end() ? len : *it;
+}
+
+int DbNet::warmup() {
+    if (session == nullptr) return 0;
+    int count = 0;
+    for (int height : shapeBuckets) {
+        for (int width : shapeBuckets) {
+            std::array<int64_t, 4> inputShape = imageShape(1, height, width);
+            if (isShapeKnown(inputShape)) continue;
+            size_t inputCount = (size_t) 3 * width * height;
+            if (rawInput) {
+                unsigned char *input = inputBytes(inputCount);
+                std::fill(input, input + inputCount, (unsigned char) 0);
+            } else {
+                float *input = inputBuffer(inputCount);
+                std::fill(input, input + inputCount, 0.f);
+            }
+            run(inputShape, outputShape);
+            ++count;
+        }
+    }
+    return count;
 }
 
+/** @brief 把 validWidth × validHeight 之外的张量区域（3 个平面）填为 value */
+static void fillTensorPadding(float *tensor, int validWidth, int validHeight, int width, int height, float value) {
+    size_t planeSize = (size_t) width * height;
+    for (int c = 0; c < 3; ++c) {
+        float *plane = tensor + c * planeSize;
+        if (validWidth < width) {
+            for (int y = 0; y < validHeight; ++y)
+                std::fill(plane + (size_t) y * width + validWidth, plane + (size_t) (y + 1) * width, value);
+        }
+        std::fill(plane + (size_t) validHeight * width, plane + planeSize, value);
+    }
+}
+
+/**
+ * @param integral 非空时按外接矩形用积分图求得分，否则按轮廓多边形求得分
+ * @param scanline 轮廓多边形得分用逐行扫描代替掩码
+ */
 std::vector<TextBox> findRsBoxes(const cv::Mat &fMapMat, const cv::Mat &norfMapMat, ScaleParam &s,
-                                 const float boxScoreThresh, const float unClipRatio) {
+                                 const float boxScoreThresh, const float unClipRatio, const cv::Mat *integral,
+                                 bool scanline) {
     float minArea = 3;
     std::vector<TextBox> rsBoxes;
     rsBoxes.clear();
@@ -53,7 +80,9 @@ std::vector<TextBox> findRsBoxes(const cv::Mat &fMapMat, const cv::Mat &norfMapM
         std::vector<cv::Point> minBox = getMinBoxes(contours[i], minSideLen, perimeter);
         if (minSideLen < minArea)
             continue;
-        float score = boxScoreFast(fMapMat, contours[i]);
+        float score = integral ? boxScoreRect(*integral, contours[i])
+                               : scanline ? boxScoreScanline(fMapMat, contours[i])
+                                          : boxScoreFast(fMapMat, contours[i]);
         if (score < boxScoreThresh)
             continue;
         //---use clipper start---
@@ -78,31 +107,118 @@ std::vector<TextBox> findRsBoxes(const cv::Mat &fMapMat, const cv::Mat &norfMapM
     return rsBoxes;
 }
 
+std::vector<TextBox> DbNet::findRsBoxesFast(const cv::Mat &fMapMat, const cv::Mat &binMat, const ScaleParam &s,
+                                            float boxScoreThresh, float unClipRatio) {
+    const float minArea = 3;
+    int count = cv::connectedComponentsWithStats(binMat, labels, stats, centroids, 8, CV_32S);
+
+    // 每个连通域外接框内每行的最左/最右像素，凸包顶点必在其中，最小外接矩形与对全部像素求一致
+    std::vector<size_t> rowOffset(count + 1, 0);
+    std::vector<int> rowTop(count, 0);
+    for (int l = 1; l < count; ++l) {
+        rowTop[l] = stats.at<int>(l, cv::CC_STAT_TOP);
+        rowOffset[l + 1] = rowOffset[l] + stats.at<int>(l, cv::CC_STAT_HEIGHT);
+    }
+    std::vector<int> rowLeft(rowOffset[count], INT_MAX), rowRight(rowOffset[count], -1);
+    std::vector<double> scoreSum(count, 0.0);
+
+    // 一次扫描累加各连通域的概率和与行端点，不再逐框 fillPoly 求均值
+    for (int y = 0; y < labels.rows; ++y) {
+        const int *label = labels.ptr<int>(y);
+        const float *prob = fMapMat.ptr<float>(y);
+        for (int x = 0; x < labels.cols; ++x) {
+            int l = label[x];
+            if (l == 0) continue;
+            scoreSum[l] += prob[x];
+            size_t r = rowOffset[l] + (y - rowTop[l]);
+            if (x < rowLeft[r]) rowLeft[r] = x;
+            if (x > rowRight[r]) rowRight[r] = x;
+        }
+    }
+
+    // 各连通域互不依赖，并行求框；结果按标号（自上而下的扫描顺序）输出
+    std::vector<TextBox> boxes(count);
+    std::vector<char> valid(count, 0);
+    cv::parallel_for_(cv::Range(1, (std::max)(count, 1)), [&](const cv::Range &range) {
+        std::vector<cv::Point> points;
+        for (int l = range.start; l < range.end; ++l) {
+            int top = rowTop[l];
+            points.clear();
+            for (size_t r = rowOffset[l]; r < rowOffset[l + 1]; ++r) {
+                if (rowRight[r] < 0) continue;
+                int y = top + (int) (r - rowOffset[l]);
+                points.emplace_back(rowLeft[r], y);
+                if (rowRight[r] != rowLeft[r]) points.emplace_back(rowRight[r], y);
+            }
+            cv::RotatedRect rect = cv::minAreaRect(points);
+            if ((std::min)(rect.size.width, rect.size.height) < minArea)
+                continue;
+            // 得分为连通域内概率均值
+            float score = (float) (scoreSum[l] / stats.at<int>(l, cv::CC_STAT_AREA));
+            if (score < boxScoreThresh)
+                continue;
+            cv::RotatedRect clipRect = unClipRect(rect, unClipRatio);
+            if ((std::min)(clipRect.size.width, clipRect.size.height) < minArea + 2)
+                continue;
+
+            std::vector<cv::Point> clipMinBox = getOrderedBox(clipRect);
+            for (int j = 0; j < clipMinBox.size(); ++j) {
+                clipMinBox[j].x = (clipMinBox[j].x / s.ratioWidth);
+                clipMinBox[j].x = (std::min)((std::max)(clipMinBox[j].x, 0), s.srcWidth);
+
+                clipMinBox[j].y = (clipMinBox[j].y / s.ratioHeight);
+                clipMinBox[j].y = (std::min)((std::max)(clipMinBox[j].y, 0), s.srcHeight);
+            }
+            boxes[l] = TextBox{clipMinBox, score};
+            valid[l] = 1;
+        }
+    });
+
+    std::vector<TextBox> rsBoxes;
+    for (int l = 1; l < count; ++l) {
+        if (valid[l]) rsBoxes.emplace_back(std::move(boxes[l]));
+    }
+    return rsBoxes;
+}
+
 std::vector<TextBox>
-DbNet::getTextBoxes(cv::Mat &src, ScaleParam &s, float boxScoreThresh, float boxThresh, float unClipRatio) {
-    cv::Mat srcResize;
+DbNet::getTextBoxes(cv::Mat &src, ScaleParam &s, float boxScoreThresh, float boxThresh, float unClipRatio,
+                    bool swapRB) {
     resize(src, srcResize, cv::Size(s.dstWidth, s.dstHeight));
-    std::vector<float> inputTensorValues = substractMeanNormalize(srcResize, meanValues, normValues);
-    std::array<int64_t, 4> inputShape{1, srcResize.channels(), srcResize.rows, srcResize.cols};
-    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memoryInfo, inputTensorValues.data(),
-                                                             inputTensorValues.size(), inputShape.data(),
-                                                             inputShape.size());
-    assert(inputTensor.IsTensor());
-    auto outputTensor = session->Run(Ort::RunOptions{nullptr}, &inputName, &inputTensor, 1, &outputName, 1);
-    assert(outputTensor.size() == 1 && outputTensor.front().IsTensor());
-    std::vector<int64_t> outputShape = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape();
-    int64_t outputCount = std::accumulate(outputShape.begin(), outputShape.end(), 1,
-                                          std::multiplies<int64_t>());
-    float *floatArray = outputTensor.front().GetTensorMutableData<float>();
+    // 分桶时图像放在桶形状张量的左上角，其余区域填归一化后的 0
+    int tensorWidth = bucketSize(srcResize.cols);
+    int tensorHeight = bucketSize(srcResize.rows);
+    bool padded = tensorWidth != srcResize.cols || tensorHeight != srcResize.rows;
+    if (rawInput) {
+        // 原始字节输入：只写 BGR 字节，归一化由模型图完成；填充为均值色
+        unsigned char *input = inputBytes((size_t) 3 * tensorWidth * tensorHeight);
+        if (padded) cv::Mat(tensorHeight, tensorWidth, CV_8UC3, input).setTo(meanPixelBgr(meanValues));
+        packToTensorBytes(srcResize, input, tensorWidth, swapRB);
+    } else {
+        // BGR 输入在归一化时交换为模型所需的 RGB；灰度 / 4 通道输入由内核直接展开为 3 平面
+        float *input = inputBuffer((size_t) 3 * tensorWidth * tensorHeight);
+        normalizeToTensor(srcResize, input, tensorWidth, tensorHeight,
+                          meanValues, normValues, swapRB);
+        if (padded)
+            fillTensorPadding(input, srcResize.cols, srcResize.rows, tensorWidth, tensorHeight, 0.f);
+    }
+    std::array<int64_t, 4> inputShape = imageShape(1, tensorHeight, tensorWidth);
+    const float *floatArray = run(inputShape, outputShape);
 
     //-----Data preparation-----
-    cv::Mat fMapMat(srcResize.rows, srcResize.cols, CV_32FC1);
-    memcpy(fMapMat.data, floatArray, outputCount * sizeof(float));
+    // 概率图直接引用工作区输出缓冲区，不复制；只取有效区域，填充区域不参与后处理
+    cv::Mat fMapMat = cv::Mat(tensorHeight, tensorWidth, CV_32FC1, (void *) floatArray)
+            (cv::Rect(0, 0, srcResize.cols, srcResize.rows));
 
     //-----boxThresh-----
-    cv::Mat norfMapMat;
-    norfMapMat = fMapMat > boxThresh;
+    cv::compare(fMapMat, boxThresh, norfMapMat, cv::CMP_GT);
 
-    return findRsBoxes(fMapMat, norfMapMat, s, boxScoreThresh, unClipRatio);
+    if (fastPostprocess)
+        return findRsBoxesFast(fMapMat, norfMapMat, s, boxScoreThresh, unClipRatio);
+    if (rectScore) {
+        // 积分图每帧只算一次，所有框 O(1) 取外接矩形内的和
+        cv::integral(fMapMat, integralMat, CV_64F);
+        return findRsBoxes(fMapMat, norfMapMat, s, boxScoreThresh, unClipRatio, &integralMat, false);
+    }
+    return findRsBoxes(fMapMat, norfMapMat, s, boxScoreThresh, unClipRatio, NULL, scanlineScore);
 }
@@ -2,32 +2,80 @@
 #define __OCR_DBNET_H__
 
 #include "OcrStruct.h"
-#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+#include "OnnxNet.h"
 #include <opencv2/opencv.hpp>
 
-class DbNet {
+class DbNet : public OnnxNet {
 public:
     DbNet();
 
     ~DbNet();
 
-    void setNumThread(int numOfThread);
-
     void initModel(const std::string &pathStr);
 
+    /**
+     * @param swapRB src 为 BGR 顺序（1/3/4 通道均可）时为 true，归一化时交换为模型所需的 RGB
+     */
     std::vector<TextBox> getTextBoxes(cv::Mat &src, ScaleParam &s, float boxScoreThresh,
-                                      float boxThresh, float unClipRatio);
+                                      float boxThresh, float unClipRatio, bool swapRB);
+
+    /**
+     * @brief 连通域后处理（默认关闭）：一次标记 + 一次扫描得到各连通域的最小外接矩形与概率均值，
+     * 矩形解析外扩代替 Clipper，各连通域并行求框
+     * 得分为连通域内概率均值（默认流程为轮廓多边形内的均值，含孔洞像素），孔洞处得分略高；
+     * 不再为连通域内部的孔洞单独生成框
+     */
+    void setFastPostprocess(bool enable) { fastPostprocess = enable; }
+
+    /**
+     * @brief 外接矩形得分（默认关闭）：得分取轮廓外接矩形内的概率均值，由每帧一次的积分图 O(1) 求得，
+     * 代替掩码求轮廓多边形内均值；矩形含轮廓外的低概率像素，得分略低于默认。连通域后处理时不生效
+     */
+    void setRectScore(bool enable) { rectScore = enable; }
+
+    /**
+     * @brief 逐行扫描得分（默认关闭）：活动边表逐行扫描轮廓多边形，直接在概率图上求和，不分配掩码；
+     * 边界像素与 fillPoly 可能相差一个像素，得分与默认略有差异。外接矩形得分或连通域后处理时不生效
+     */
+    void setScanlineScore(bool enable) { scanlineScore = enable; }
+
+    /**
+     * @brief 输入形状分桶（默认为空，不分桶）：缩放后的宽、高分别向上取到 sizes 中不小于它的最小边长，
+     * 图像放在张量左上角，其余区域填 0（归一化后的均值色），后处理只取有效区域的概率图
+     * 输入形状只有 sizes.size()² 种，ORT 的内存规划与工作区绑定在稳态下不再因新形状重建
+     * 边长超过最大桶时按原尺寸推理
+     * @param sizes 桶边长（向上取整为 32 的倍数，去重排序），空表示关闭
+     * @return 桶是否变化
+     */
+    bool setShapeBuckets(const std::vector<int> &sizes);
+
+    /**
+     * @brief 预热：以全 0 输入把每种桶形状各推理一次，跳过当前会话已执行过的形状，会话未加载时不执行
+     * @return 本次实际推理的形状数
+     */
+    int warmup();
 
 private:
-    Ort::Session *session;
-    Ort::Env env = Ort::Env(ORT_LOGGING_LEVEL_ERROR, "DbNet");
-    Ort::SessionOptions sessionOptions = Ort::SessionOptions();
-    int numThread = 0;
-    char *inputName;
-    char *outputName;
+    bool fastPostprocess = false;
+    bool rectScore = false;
+    bool scanlineScore = false;
+    std::vector<int> shapeBuckets;
+
+    /** @brief 不小于 len 的最小桶边长，超过最大桶或未分桶时返回 len */
+    int bucketSize(int len) const;
 
     const float meanValues[3] = {0.485 * 255, 0.456 * 255, 0.406 * 255};
     const float normValues[3] = {1.0 / 0.229 / 255.0, 1.0 / 0.224 / 255.0, 1.0 / 0.225 / 255.0};
+
+    // 跨调用复用的缓冲区，尺寸不变时不再分配
+    cv::Mat srcResize;
+    cv::Mat norfMapMat;
+    std::vector<int64_t> outputShape;
+    cv::Mat labels, stats, centroids;
+    cv::Mat integralMat;
+
+    std::vector<TextBox> findRsBoxesFast(const cv::Mat &fMapMat, const cv::Mat &binMat, const ScaleParam &s,
+                                         float boxScoreThresh, float unClipRatio);
 };
 
 
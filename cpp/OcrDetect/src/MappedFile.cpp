@@ -0,0 +1,91 @@
+#include "MappedFile.h"
+#include "OcrUtils.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::swap(MappedFile &other) {
+    std::swap(addr, other.addr);
+    std::swap(length, other.length);
+#ifdef _WIN32
+    std::swap(mapping, other.mapping);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &pathStr) {
+    close();
+    std::wstring wPath = strToWstr(pathStr);
+    HANDLE file = CreateFileW(wPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    // 映射对象持有文件引用，文件句柄可立即关闭
+    HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (fileMapping == nullptr) return false;
+    void *view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(fileMapping);
+        return false;
+    }
+    addr = view;
+    length = (size_t) fileSize.QuadPart;
+    mapping = fileMapping;
+    return true;
+}
+
+void MappedFile::close() {
+    if (addr != nullptr) UnmapViewOfFile(addr);
+    if (mapping != nullptr) CloseHandle((HANDLE) mapping);
+    addr = nullptr;
+    mapping = nullptr;
+    length = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string &pathStr) {
+    close();
+    int fd = ::open(pathStr.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    // MAP_SHARED + 只读：各进程映射同一文件时共用页缓存中的物理页
+    void *view = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    addr = view;
+    length = (size_t) st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (addr != nullptr) munmap(addr, length);
+    addr = nullptr;
+    length = 0;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef __OCR_MAPPEDFILE_H__
+#define __OCR_MAPPEDFILE_H__
+
+#include <cstddef>
+#include <string>
+
+/**
+ * 只读内存映射文件（Linux mmap / Windows MapViewOfFile）
+ * 同一文件被多个进程映射时共享物理页，用于从映射字节创建 ORT 会话
+ */
+class MappedFile {
+public:
+    MappedFile() {}
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief 映射文件，重复调用会先解除旧映射
+     * @return 文件不存在、为空或映射失败时返回 false
+     */
+    bool open(const std::string &pathStr);
+
+    void close();
+
+    /** @brief 交换两个映射，不解除任何映射（会话切换到新映射后再释放旧映射） */
+    void swap(MappedFile &other);
+
+    const void *data() const { return addr; }
+
+    size_t size() const { return length; }
+
+    bool isOpen() const { return addr != nullptr; }
+
+private:
+    void *addr = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *mapping = nullptr;
+#endif
+};
+
+
+#endif //__OCR_MAPPEDFILE_H__
@@ -0,0 +1,524 @@
+#include "OcrKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define OCR_KERNELS_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define OCR_TARGET(isa)
+#  else
+#    define OCR_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#  define OCR_KERNELS_NEON 1
+#  include <arm_neon.h>
+#endif
+
+namespace {
+
+enum KernelIsa {
+    ISA_SCALAR = 0,
+    ISA_SSE41,
+    ISA_AVX2,
+    ISA_NEON
+};
+
+KernelIsa detectIsa() {
+#if defined(OCR_KERNELS_X86)
+#  if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#  else
+    __builtin_cpu_init();
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#  endif
+    if (avx2) return ISA_AVX2;
+    if (sse41) return ISA_SSE41;
+    return ISA_SCALAR;
+#elif defined(OCR_KERNELS_NEON)
+    return ISA_NEON;
+#else
+    return ISA_SCALAR;
+#endif
+}
+
+KernelIsa currentIsa() {
+    static const KernelIsa isa = detectIsa();
+    return isa;
+}
+
+//============================== normalizeToPlanar ==============================
+
+struct PlanarParams {
+    float scale[3];   // normVals
+    float bias[3];    // -meanVals * normVals
+    int srcIndex[3];  // 输出平面 c 取自源像素的第 srcIndex[c] 个通道
+};
+
+// 返回已处理的像素数，剩余部分由标量代码补齐
+typedef int (*PlanarRowFn)(const unsigned char *row, int width, int srcChannels,
+                           float *const dst[3], const PlanarParams &p);
+
+void planarRowScalar(const unsigned char *row, int x0, int width, int srcChannels,
+                     float *const dst[3], const PlanarParams &p) {
+    if (srcChannels == 1) {
+        for (int x = x0; x < width; ++x) {
+            float v = row[x];
+            dst[0][x] = v * p.scale[0] + p.bias[0];
+            dst[1][x] = v * p.scale[1] + p.bias[1];
+            dst[2][x] = v * p.scale[2] + p.bias[2];
+        }
+        return;
+    }
+    for (int x = x0; x < width; ++x) {
+        const unsigned char *px = row + x * srcChannels;
+        dst[0][x] = px[p.srcIndex[0]] * p.scale[0] + p.bias[0];
+        dst[1][x] = px[p.srcIndex[1]] * p.scale[1] + p.bias[1];
+        dst[2][x] = px[p.srcIndex[2]] * p.scale[2] + p.bias[2];
+    }
+}
+
+#if defined(OCR_KERNELS_X86)
+
+// 16 个 u8 -> 16 个 float，乘 scale 加 bias 后写出
+OCR_TARGET("sse4.1")
+inline void storeU8x16Sse(__m128i v, float *dst, __m128 scale, __m128 bias) {
+    __m128 f0 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(v));
+    __m128 f1 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+    __m128 f2 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    __m128 f3 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_mul_ps(f0, scale), bias));
+    _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_mul_ps(f1, scale), bias));
+    _mm_storeu_ps(dst + 8, _mm_add_ps(_mm_mul_ps(f2, scale), bias));
+    _mm_storeu_ps(dst + 12, _mm_add_ps(_mm_mul_ps(f3, scale), bias));
+}
+
+OCR_TARGET("avx2")
+inline void storeU8x16Avx2(__m128i v, float *dst, __m256 scale, __m256 bias) {
+    __m256 f0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+    __m256 f1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_mul_ps(f0, scale), bias));
+    _mm256_storeu_ps(dst + 8, _mm256_add_ps(_mm256_mul_ps(f1, scale), bias));
+}
+
+// 48 字节（16 个 3 通道像素）拆分为 3 个通道向量
+OCR_TARGET("sse4.1")
+inline void deinterleave3Sse(const unsigned char *p, __m128i ch[3]) {
+    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16));
+    const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32));
+    const __m128i m00 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i m01 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i m02 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i m10 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i m11 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i m12 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i m20 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i m21 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i m22 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+    ch[0] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m00), _mm_shuffle_epi8(a1, m01)),
+                         _mm_shuffle_epi8(a2, m02));
+    ch[1] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m10), _mm_shuffle_epi8(a1, m11)),
+                         _mm_shuffle_epi8(a2, m12));
+    ch[2] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m20), _mm_shuffle_epi8(a1, m21)),
+                         _mm_shuffle_epi8(a2, m22));
+}
+
+// 16 字节（4 个 4 通道像素）按通道重排为 [c0 x4, c1 x4, c2 x4, c3 x4]
+OCR_TARGET("sse4.1")
+inline __m128i deinterleave4Sse(const unsigned char *p) {
+    const __m128i m = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), m);
+}
+
+OCR_TARGET("sse4.1")
+int planarRowSse41(const unsigned char *row, int width, int srcChannels,
+                   float *const dst[3], const PlanarParams &p) {
+    __m128 scale[3], bias[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = _mm_set1_ps(p.scale[c]);
+        bias[c] = _mm_set1_ps(p.bias[c]);
+    }
+    int x = 0;
+    if (srcChannels == 3) {
+        __m128i ch[3];
+        for (; x + 16 <= width; x += 16) {
+            deinterleave3Sse(row + x * 3, ch);
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Sse(ch[p.srcIndex[c]], dst[c] + x, scale[c], bias[c]);
+        }
+    } else if (srcChannels == 4) {
+        for (; x + 4 <= width; x += 4) {
+            __m128i t = deinterleave4Sse(row + x * 4);
+            __m128i ch[3] = {t, _mm_srli_si128(t, 4), _mm_srli_si128(t, 8)};
+            for (int c = 0; c < 3; ++c) {
+                __m128 f = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(ch[p.srcIndex[c]]));
+                _mm_storeu_ps(dst[c] + x, _mm_add_ps(_mm_mul_ps(f, scale[c]), bias[c]));
+            }
+        }
+    } else if (srcChannels == 1) {
+        for (; x + 16 <= width; x += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Sse(v, dst[c] + x, scale[c], bias[c]);
+        }
+    }
+    return x;
+}
+
+OCR_TARGET("avx2")
+int planarRowAvx2(const unsigned char *row, int width, int srcChannels,
+                  float *const dst[3], const PlanarParams &p) {
+    if (srcChannels == 4)
+        return planarRowSse41(row, width, srcChannels, dst, p);
+    __m256 scale[3], bias[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = _mm256_set1_ps(p.scale[c]);
+        bias[c] = _mm256_set1_ps(p.bias[c]);
+    }
+    int x = 0;
+    if (srcChannels == 3) {
+        __m128i ch[3];
+        for (; x + 16 <= width; x += 16) {
+            deinterleave3Sse(row + x * 3, ch);
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Avx2(ch[p.srcIndex[c]], dst[c] + x, scale[c], bias[c]);
+        }
+    } else if (srcChannels == 1) {
+        for (; x + 16 <= width; x += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Avx2(v, dst[c] + x, scale[c], bias[c]);
+        }
+    }
+    return x;
+}
+
+#endif // OCR_KERNELS_X86
+
+#if defined(OCR_KERNELS_NEON)
+
+inline void storeU8x16Neon(uint8x16_t v, float *dst, float32x4_t scale, float32x4_t bias) {
+    uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+    vst1q_f32(dst, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+    vst1q_f32(dst + 4, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+    vst1q_f32(dst + 8, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+    vst1q_f32(dst + 12, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+}
+
+int planarRowNeon(const unsigned char *row, int width, int srcChannels,
+                  float *const dst[3], const PlanarParams &p) {
+    float32x4_t scale[3], bias[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = vdupq_n_f32(p.scale[c]);
+        bias[c] = vdupq_n_f32(p.bias[c]);
+    }
+    int x = 0;
+    if (srcChannels == 3) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x3_t v = vld3q_u8(row + x * 3);
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Neon(v.val[p.srcIndex[c]], dst[c] + x, scale[c], bias[c]);
+        }
+    } else if (srcChannels == 4) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x4_t v = vld4q_u8(row + x * 4);
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Neon(v.val[p.srcIndex[c]], dst[c] + x, scale[c], bias[c]);
+        }
+    } else if (srcChannels == 1) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16_t v = vld1q_u8(row + x);
+            for (int c = 0; c < 3; ++c)
+                storeU8x16Neon(v, dst[c] + x, scale[c], bias[c]);
+        }
+    }
+    return x;
+}
+
+#endif // OCR_KERNELS_NEON
+
+//============================== sumFloats ==============================
+
+typedef float (*SumFn)(const float *data, int count);
+
+float sumScalar(const float *data, int count) {
+    float sum = 0.f;
+    for (int i = 0; i < count; ++i) sum += data[i];
+    return sum;
+}
+
+#if defined(OCR_KERNELS_X86)
+
+OCR_TARGET("sse4.1")
+float sumSse41(const float *data, int count) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(data + i));
+        acc1 = _mm_add_ps(acc1, _mm_loadu_ps(data + i + 4));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_hadd_ps(acc, acc);
+    acc = _mm_hadd_ps(acc, acc);
+    return _mm_cvtss_f32(acc) + sumScalar(data + i, count - i);
+}
+
+OCR_TARGET("avx2")
+float sumAvx2(const float *data, int count) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(data + i));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(data + i + 8));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_hadd_ps(half, half);
+    half = _mm_hadd_ps(half, half);
+    return _mm_cvtss_f32(half) + sumScalar(data + i, count - i);
+}
+
+#endif // OCR_KERNELS_X86
+
+#if defined(OCR_KERNELS_NEON)
+
+float sumNeon(const float *data, int count) {
+    float32x4_t acc0 = vdupq_n_f32(0.f), acc1 = vdupq_n_f32(0.f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vaddq_f32(acc0, vld1q_f32(data + i));
+        acc1 = vaddq_f32(acc1, vld1q_f32(data + i + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0) + sumScalar(data + i, count - i);
+}
+
+#endif // OCR_KERNELS_NEON
+
+SumFn selectSum() {
+    switch (currentIsa()) {
+#if defined(OCR_KERNELS_X86)
+        case ISA_AVX2:
+            return sumAvx2;
+        case ISA_SSE41:
+            return sumSse41;
+#endif
+#if defined(OCR_KERNELS_NEON)
+        case ISA_NEON:
+            return sumNeon;
+#endif
+        default:
+            return sumScalar;
+    }
+}
+
+//============================== argmaxFloats ==============================
+
+typedef int (*ArgmaxFn)(const float *data, int count, float *maxValue);
+
+int argmaxScalar(const float *data, int count, float *maxValue) {
+    int bestIndex = 0;
+    float bestValue = data[0];
+    for (int i = 1; i < count; ++i) {
+        if (data[i] > bestValue) {
+            bestValue = data[i];
+            bestIndex = i;
+        }
+    }
+    *maxValue = bestValue;
+    return bestIndex;
+}
+
+/**
+ * @brief 合并各通道的 (最大值, 首次下标)，再扫描 [tail, count) 的尾部元素
+ * 每个通道只在严格大于时更新下标，通道间取最大值中下标最小者，即全局首个最大值
+ */
+int reduceArgmax(const float *laneValues, const int *laneIndices, int lanes,
+                 const float *data, int tail, int count, float *maxValue) {
+    int bestIndex = laneIndices[0];
+    float bestValue = laneValues[0];
+    for (int k = 1; k < lanes; ++k) {
+        if (laneValues[k] > bestValue || (laneValues[k] == bestValue && laneIndices[k] < bestIndex)) {
+            bestValue = laneValues[k];
+            bestIndex = laneIndices[k];
+        }
+    }
+    for (int i = tail; i < count; ++i) {
+        if (data[i] > bestValue) {
+            bestValue = data[i];
+            bestIndex = i;
+        }
+    }
+    *maxValue = bestValue;
+    return bestIndex;
+}
+
+#if defined(OCR_KERNELS_X86)
+
+OCR_TARGET("sse4.1")
+int argmaxSse41(const float *data, int count, float *maxValue) {
+    if (count < 4) return argmaxScalar(data, count, maxValue);
+    __m128 best = _mm_loadu_ps(data);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i bestIndex = index;
+    const __m128i step = _mm_set1_epi32(4);
+    int i = 4;
+    for (; i + 4 <= count; i += 4) {
+        index = _mm_add_epi32(index, step);
+        __m128 v = _mm_loadu_ps(data + i);
+        __m128 greater = _mm_cmpgt_ps(v, best);
+        best = _mm_blendv_ps(best, v, greater);
+        bestIndex = _mm_blendv_epi8(bestIndex, index, _mm_castps_si128(greater));
+    }
+    float laneValues[4];
+    int laneIndices[4];
+    _mm_storeu_ps(laneValues, best);
+    _mm_storeu_si128((__m128i *) laneIndices, bestIndex);
+    return reduceArgmax(laneValues, laneIndices, 4, data, i, count, maxValue);
+}
+
+OCR_TARGET("avx2")
+int argmaxAvx2(const float *data, int count, float *maxValue) {
+    if (count < 8) return argmaxScalar(data, count, maxValue);
+    __m256 best = _mm256_loadu_ps(data);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i bestIndex = index;
+    const __m256i step = _mm256_set1_epi32(8);
+    int i = 8;
+    for (; i + 8 <= count; i += 8) {
+        index = _mm256_add_epi32(index, step);
+        __m256 v = _mm256_loadu_ps(data + i);
+        __m256 greater = _mm256_cmp_ps(v, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, v, greater);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(greater));
+    }
+    float laneValues[8];
+    int laneIndices[8];
+    _mm256_storeu_ps(laneValues, best);
+    _mm256_storeu_si256((__m256i *) laneIndices, bestIndex);
+    return reduceArgmax(laneValues, laneIndices, 8, data, i, count, maxValue);
+}
+
+#endif // OCR_KERNELS_X86
+
+#if defined(OCR_KERNELS_NEON)
+
+int argmaxNeon(const float *data, int count, float *maxValue) {
+    if (count < 4) return argmaxScalar(data, count, maxValue);
+    float32x4_t best = vld1q_f32(data);
+    const int32_t initIndex[4] = {0, 1, 2, 3};
+    int32x4_t index = vld1q_s32(initIndex);
+    int32x4_t bestIndex = index;
+    const int32x4_t step = vdupq_n_s32(4);
+    int i = 4;
+    for (; i + 4 <= count; i += 4) {
+        index = vaddq_s32(index, step);
+        float32x4_t v = vld1q_f32(data + i);
+        uint32x4_t greater = vcgtq_f32(v, best);
+        best = vbslq_f32(greater, v, best);
+        bestIndex = vbslq_s32(greater, index, bestIndex);
+    }
+    float laneValues[4];
+    int laneIndices[4];
+    vst1q_f32(laneValues, best);
+    vst1q_s32(laneIndices, bestIndex);
+    return reduceArgmax(laneValues, laneIndices, 4, data, i, count, maxValue);
+}
+
+#endif // OCR_KERNELS_NEON
+
+ArgmaxFn selectArgmax() {
+    switch (currentIsa()) {
+#if defined(OCR_KERNELS_X86)
+        case ISA_AVX2:
+            return argmaxAvx2;
+        case ISA_SSE41:
+            return argmaxSse41;
+#endif
+#if defined(OCR_KERNELS_NEON)
+        case ISA_NEON:
+            return argmaxNeon;
+#endif
+        default:
+            return argmaxScalar;
+    }
+}
+
+PlanarRowFn selectPlanarRow() {
+    switch (currentIsa()) {
+#if defined(OCR_KERNELS_X86)
+        case ISA_AVX2:
+            return planarRowAvx2;
+        case ISA_SSE41:
+            return planarRowSse41;
+#endif
+#if defined(OCR_KERNELS_NEON)
+        case ISA_NEON:
+            return planarRowNeon;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+void normalizeToPlanar(const unsigned char *src, int width, int height, size_t srcStep, int srcChannels,
+                       float *dst, int dstStride, size_t planeSize,
+                       const float *meanVals, const float *normVals, bool swapRB) {
+    PlanarParams p;
+    for (int c = 0; c < 3; ++c) {
+        p.scale[c] = normVals[c];
+        p.bias[c] = -(meanVals[c] * normVals[c]);
+        p.srcIndex[c] = srcChannels == 1 ? 0 : (swapRB ? 2 - c : c);
+    }
+    static const PlanarRowFn rowFn = selectPlanarRow();
+    for (int y = 0; y < height; ++y) {
+        const unsigned char *row = src + y * srcStep;
+        float *const rowDst[3] = {dst + (size_t) y * dstStride,
+                                  dst + planeSize + (size_t) y * dstStride,
+                                  dst + 2 * planeSize + (size_t) y * dstStride};
+        int done = rowFn ? rowFn(row, width, srcChannels, rowDst, p) : 0;
+        planarRowScalar(row, done, width, srcChannels, rowDst, p);
+    }
+}
+
+float sumFloats(const float *data, int count) {
+    static const SumFn sumFn = selectSum();
+    return count > 0 ? sumFn(data, count) : 0.f;
+}
+
+int argmaxFloats(const float *data, int count, float *maxValue) {
+    static const ArgmaxFn argmaxFn = selectArgmax();
+    float value;
+    int index = argmaxFn(data, count, &value);
+    if (maxValue) *maxValue = value;
+    return index;
+}
+
+const char *kernelIsaName() {
+    switch (currentIsa()) {
+        case ISA_AVX2:
+            return "avx2";
+        case ISA_SSE41:
+            return "sse4.1";
+        case ISA_NEON:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef __OCR_KERNELS_H__
+#define __OCR_KERNELS_H__
+
+#include <cstddef>
+
+/**
+ * 预处理/后处理的 SIMD 内核（x86 SSE4.1/AVX2，ARM NEON，运行时按 CPU 特性分派）
+ * 仅依赖原始指针，不依赖 OpenCV / ONNX Runtime
+ */
+
+/**
+ * @brief 8 位 HWC 图像 -> 3 平面 CHW float，一次完成通道交换、减均值乘系数与平面转置
+ * dst[c][y][x] = src[y][x][sc] * normVals[c] - meanVals[c] * normVals[c]
+ * @param src         首行首像素地址
+ * @param width       有效宽度（像素）
+ * @param height      有效高度（像素）
+ * @param srcStep     源图行步长（字节），支持 ROI/调用方缓冲区
+ * @param srcChannels 源通道数：1（灰度复制到 3 个平面）、3、4（忽略 alpha）
+ * @param dst         第 0 个平面的起始地址
+ * @param dstStride   输出平面的行步长（元素数），>= width，右侧剩余部分不写
+ * @param planeSize   平面间隔（元素数）
+ * @param swapRB      true 时输出平面 0 取源通道 2（BGR -> RGB）
+ */
+void normalizeToPlanar(const unsigned char *src, int width, int height, size_t srcStep, int srcChannels,
+                       float *dst, int dstStride, size_t planeSize,
+                       const float *meanVals, const float *normVals, bool swapRB);
+
+/**
+ * @brief float 数组求和（多路累加，求和顺序与逐个相加不同，误差在 float 精度内）
+ */
+float sumFloats(const float *data, int count);
+
+/**
+ * @brief float 数组的最大值下标，有多个最大值时取第一个（与逐个比较 > 的结果一致）
+ * @param count    元素数，须 > 0
+ * @param maxValue 非空时写入最大值
+ */
+int argmaxFloats(const float *data, int count, float *maxValue);
+
+/** @brief 当前分派到的指令集名称（"avx2" / "sse4.1" / "neon" / "scalar"），用于日志 */
+const char *kernelIsaName();
+
+#endif //__OCR_KERNELS_H__
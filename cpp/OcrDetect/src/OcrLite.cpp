@@ -1,24 +1,22 @@
 #include "OcrLite.h"
 #include "OcrUtils.h"
+#include "OcrKernels.h"
+#include "CropSource.h"
 #include <stdarg.h> //windows&linux
+#include <cmath>
 #include <string>
 
-// 预处理图像保存路径（全局变量用于调试）
-static std::string g_preprocessSavePath = "";
-// 裁剪后的文本框图像保存目录（非空则保存 part_0.png, part_1.png, ...）
-static std::string g_partImagesSavePath = "";
-
 OcrLite::OcrLite() : enablePreprocess_(false) {}
 // 注意：enablePreprocess_ 默认禁用，因为 Python OnnxOCR 不做任何预处理
 // CLAHE + 锐化会改变像素分布，导致 rec 模型无法正确识别
 // 如需启用预处理，请调用 setPreprocess(true)
 
 void OcrLite::setPreprocessSavePath(const std::string& path) {
-    g_preprocessSavePath = path;
+    preprocessSavePath_ = path;
 }
 
 void OcrLite::setPartImagesSavePath(const std::string& path) {
-    g_partImagesSavePath = path;
+    partImagesSavePath_ = path;
 }
 
 /**
@@ -26,10 +24,10 @@ void OcrLite::setPartImagesSavePath(const std::string& path) {
  * 
  * 针对低对比度、浅色文字等情况进行增强处理
  */
-cv::Mat preprocessImage(const cv::Mat& src) {
+cv::Mat preprocessImage(const cv::Mat& src, const std::string& savePath) {
     cv::Mat result = src.clone();
     cv::Mat lab;
-    cv::cvtColor(result, lab, cv::COLOR_RGB2Lab);
+    cv::cvtColor(result, lab, cv::COLOR_BGR2Lab);
     std::vector<cv::Mat> labChannels;
     cv::split(lab, labChannels);
     cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE();
@@ -37,16 +35,14 @@ cv::Mat preprocessImage(const cv::Mat& src) {
     clahe->setTilesGridSize(cv::Size(8, 8));
     clahe->apply(labChannels[0], labChannels[0]);
     cv::merge(labChannels, lab);
-    cv::cvtColor(lab, result, cv::COLOR_Lab2RGB);
+    cv::cvtColor(lab, result, cv::COLOR_Lab2BGR);
     cv::Mat sharpened;
     cv::Mat kernel = (cv::Mat_<float>(3, 3) << 0, -1, 0, -1, 5, -1, 0, -1, 0);
     cv::filter2D(result, sharpened, -1, kernel);
     cv::addWeighted(result, 0.5, sharpened, 0.5, 0, result);
-    if (!g_preprocessSavePath.empty()) {
-        cv::Mat bgr;
-        cv::cvtColor(result, bgr, cv::COLOR_RGB2BGR);
-        if (!cv::imwrite(g_preprocessSavePath, bgr))
-            fprintf(stderr, "预处理图保存失败: %s\n", g_preprocessSavePath.c_str());
+    if (!savePath.empty()) {
+        if (!cv::imwrite(savePath, result))
+            fprintf(stderr, "预处理图保存失败: %s\n", savePath.c_str());
     }
     return result;
 }
@@ -63,6 +59,65 @@ void OcrLite::setNumThread(int numOfThread) {
     crnnNet.setNumThread(numOfThread);
 }
 
+void OcrLite::setModelThreads(int detThreads, int clsThreads, int recThreads) {
+    if (detThreads > 0) dbNet.setNumThread(detThreads);
+    if (clsThreads > 0) angleNet.setNumThread(clsThreads);
+    if (recThreads > 0) crnnNet.setNumThread(recThreads);
+}
+
+void OcrLite::applyDetSessionOptions() {
+    // 重建的 det 会话不认识已预热的形状
+    if (dbNet.applySessionOptions()) {
+        int count = dbNet.warmup();
+        if (count > 0) Logger("DbNet warmup shapes: %d\n", count);
+    }
+}
+
+void OcrLite::applyRecSessionOptions() {
+    angleNet.applySessionOptions();
+    crnnNet.applySessionOptions();
+}
+
+void OcrLite::setThreadSpinning(bool allow) {
+    dbNet.setThreadSpinning(allow);
+    angleNet.setThreadSpinning(allow);
+    crnnNet.setThreadSpinning(allow);
+}
+
+void OcrLite::setClsBatchNum(int batchNum) {
+    angleNet.setBatchSize(batchNum);
+}
+
+void OcrLite::setRecBatchNum(int batchNum) {
+    crnnNet.setBatchSize(batchNum);
+}
+
+void OcrLite::setModelCacheDir(const std::string &dir) {
+    dbNet.setModelCacheDir(dir);
+    angleNet.setModelCacheDir(dir);
+    crnnNet.setModelCacheDir(dir);
+}
+
+void OcrLite::setUseMmap(bool use) {
+    dbNet.setUseMmap(use);
+    angleNet.setUseMmap(use);
+    crnnNet.setUseMmap(use);
+}
+
+void OcrLite::setDetTiling(int tileSize, int overlap) {
+    detTileSize_ = tileSize <= 0 ? 0 : (std::max)(32, tileSize / 32 * 32);
+    detTileOverlap_ = (std::max)(0, overlap);
+}
+
+void OcrLite::setDetShapeBuckets(const std::vector<int> &sizes) {
+    // 先应用挂起的线程参数，避免预热后紧接着重建会话再预热一遍
+    applyDetSessionOptions();
+    if (dbNet.setShapeBuckets(sizes)) {
+        int count = dbNet.warmup();
+        if (count > 0) Logger("DbNet warmup shapes: %d\n", count);
+    }
+}
+
 void OcrLite::initLogger(bool isConsole, bool isPartImg, bool isResultImg) {
     isOutputConsole = isConsole;
     isOutputPartImg = isPartImg;
@@ -78,14 +133,23 @@ void OcrLite::enableResultTxt(const char *path, const char *imgName) {
 bool OcrLite::initModels(const std::string &detPath, const std::string &clsPath,
                          const std::string &recPath, const std::string &keysPath) {
     Logger("=====Init Models=====\n");
+    Logger("Kernel ISA: %s\n", kernelIsaName());
     Logger("--- Init DbNet ---\n");
     dbNet.initModel(detPath);
+    Logger("DbNet from cache: %d\n", dbNet.isLoadedFromCache());
+    Logger("DbNet raw input: %d\n", dbNet.isRawInput());
+    int warmupCount = dbNet.warmup();
+    if (warmupCount > 0) Logger("DbNet warmup shapes: %d\n", warmupCount);
 
     Logger("--- Init AngleNet ---\n");
     angleNet.initModel(clsPath);
+    Logger("AngleNet from cache: %d\n", angleNet.isLoadedFromCache());
+    Logger("AngleNet raw input: %d\n", angleNet.isRawInput());
 
     Logger("--- Init CrnnNet ---\n");
     crnnNet.initModel(recPath, keysPath);
+    Logger("CrnnNet from cache: %d\n", crnnNet.isLoadedFromCache());
+    Logger("CrnnNet raw input: %d\n", crnnNet.isRawInput());
 
     Logger("Init Models Success!\n");
     return true;
@@ -96,32 +160,52 @@ void OcrLite::Logger(const char *format, ...) {
     char *buffer = (char *) malloc(8192);
     va_list args;
     va_start(args, format);
-    vsprintf(buffer, format, args);
+    vsnprintf(buffer, 8192, format, args);
     va_end(args);
-    if (isOutputConsole) printf("%s", buffer);
-    if (isOutputResultTxt) fprintf(resultTxt, "%s", buffer);
+    {
+        // 格式化在锁外完成，只有写出串行化
+        std::lock_guard<std::mutex> lock(logMutex);
+        if (isOutputConsole) printf("%s", buffer);
+        if (isOutputResultTxt) fprintf(resultTxt, "%s", buffer);
+    }
     free(buffer);
 }
 
+/**
+ * @brief 任意 1/3/4 通道 8 位图转为 3 通道 BGR（已是 BGR 时不复制）
+ * @param rgbOrder 3/4 通道输入为 RGB(A) 顺序
+ */
+static cv::Mat toBgr(const cv::Mat &src, bool rgbOrder) {
+    cv::Mat bgr;
+    switch (src.channels()) {
+        case 1:
+            cvtColor(src, bgr, cv::COLOR_GRAY2BGR);
+            break;
+        case 4:
+            cvtColor(src, bgr, rgbOrder ? cv::COLOR_RGBA2BGR : cv::COLOR_BGRA2BGR);
+            break;
+        default:
+            if (rgbOrder)
+                cvtColor(src, bgr, cv::COLOR_RGB2BGR);
+            else
+                bgr = src;
+            break;
+    }
+    return bgr;
+}
+
 cv::Mat makePadding(cv::Mat &src, const int padding) {
     if (padding <= 0) return src;
-    cv::Scalar paddingScalar = {255, 255, 255};
+    cv::Scalar paddingScalar = {255, 255, 255, 255};
     cv::Mat paddingSrc;
     cv::copyMakeBorder(src, paddingSrc, padding, padding, padding, padding, cv::BORDER_ISOLATED, paddingScalar);
     return paddingSrc;
 }
 
-OcrResult OcrLite::detect(const char *path, const char *imgName,
-                          const int padding, const int shortSideLen,
-                          float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle) {
-    std::string imgFile = getSrcImgFilePath(path, imgName);
-    cv::Mat bgrSrc = imread(imgFile, cv::IMREAD_COLOR);
-    if (bgrSrc.empty()) {
-        fprintf(stderr, "无法加载图像: %s\n", imgFile.c_str());
-        return OcrResult{};
-    }
-    cv::Mat originSrc;
-    cvtColor(bgrSrc, originSrc, cv::COLOR_BGR2RGB);
+/**
+ * @brief 外扩白边并计算缩放参数，填充 frame.src / originRect / scale
+ */
+static void prepareFrame(cv::Mat &originSrc, int padding, int shortSideLen, OcrFrame &frame) {
     int originMinSide = (std::min)(originSrc.cols, originSrc.rows);
     int originMaxSide = (std::max)(originSrc.cols, originSrc.rows);
     int resize;
@@ -133,53 +217,76 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
         resize = 32 * (resize / 32);
         if (resize < 32) resize = 32;
     }
-    resize += 2*padding;
-    cv::Rect paddingRect(padding, padding, originSrc.cols, originSrc.rows);
-    cv::Mat paddingSrc = makePadding(originSrc, padding);
-    ScaleParam scale = getScaleParam(paddingSrc, resize);
-    return detect(path, imgName, paddingSrc, paddingRect, scale,
-                  boxScoreThresh, boxThresh, unClipRatio, doAngle, mostAngle);
+    resize += 2 * padding;
+    frame.originRect = cv::Rect(padding, padding, originSrc.cols, originSrc.rows);
+    frame.src = makePadding(originSrc, padding);
+    frame.scale = getScaleParam(frame.src, resize);
+}
+
+OcrResult OcrLite::detect(const char *path, const char *imgName,
+                          const int padding, const int shortSideLen,
+                          float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle) {
+    std::string imgFile = getSrcImgFilePath(path, imgName);
+    // 全流程保持 BGR，由各模型的归一化内核在写入张量时交换为 RGB
+    cv::Mat originSrc = imread(imgFile, cv::IMREAD_COLOR);
+    if (originSrc.empty()) {
+        fprintf(stderr, "无法加载图像: %s\n", imgFile.c_str());
+        return OcrResult{};
+    }
+    OcrFrame frame{};
+    prepareFrame(originSrc, padding, shortSideLen, frame);
+    detectBoxes(path, imgName, frame, boxScoreThresh, boxThresh, unClipRatio);
+    return recognizeBoxes(path, imgName, frame, doAngle, mostAngle);
 }
 
-OcrResult OcrLite::detect(const cv::Mat& mat, int padding, int shortSideLen, float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle)
+OcrResult OcrLite::detect(const cv::Mat& mat, int padding, int shortSideLen, float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle, bool rgbOrder)
 {
+    OcrFrame frame = detectStage(mat, padding, shortSideLen, boxScoreThresh, boxThresh, unClipRatio, rgbOrder);
+    return recognizeStage(frame, doAngle, mostAngle);
+}
+
+OcrFrame OcrLite::detectStage(const cv::Mat &mat, int padding, int shortSideLen,
+                              float boxScoreThresh, float boxThresh, float unClipRatio, bool rgbOrder) {
+    OcrFrame frame{};
     if (mat.empty()) {
         fprintf(stderr, "输入图像为空\n");
-        return OcrResult{};
+        return frame;
     }
-    cv::Mat originSrc;
-    cvtColor(mat, originSrc, cv::COLOR_BGR2RGB);
-    if (enablePreprocess_)
-        originSrc = preprocessImage(originSrc);
-    int originMinSide = (std::min)(originSrc.cols, originSrc.rows);
-    int originMaxSide = (std::max)(originSrc.cols, originSrc.rows);
-    int resize;
-    if (shortSideLen <= 0 || shortSideLen >= originMinSide) {
-        resize = originMaxSide;
-    } else {
-        float scale = (float)shortSideLen / (float)originMinSide;
-        resize = (int)(originMaxSide * scale);
-        resize = 32 * (resize / 32);
-        if (resize < 32) resize = 32;
+    // 不做整图颜色转换：灰度 / 3 通道 / 4 通道直接进入后续流程，
+    // 由各模型的归一化内核在写入张量时展开通道、按需交换 R/B
+    cv::Mat originSrc = mat;
+    frame.swapRB = !rgbOrder;
+    if (enablePreprocess_) {
+        // CLAHE 预处理基于 BGR -> Lab，只有此时才统一为 3 通道 BGR
+        if (mat.channels() != 3 || rgbOrder)
+            originSrc = toBgr(mat, rgbOrder);
+        originSrc = preprocessImage(originSrc, preprocessSavePath_);
+        frame.swapRB = true;
     }
-    resize += 2 * padding;
-    cv::Rect paddingRect(padding, padding, originSrc.cols, originSrc.rows);
-    cv::Mat paddingSrc = makePadding(originSrc, padding);
-    ScaleParam scale = getScaleParam(paddingSrc, resize);
-    return detect(NULL, NULL, paddingSrc, paddingRect, scale,
-        boxScoreThresh, boxThresh, unClipRatio, doAngle, mostAngle);
+    prepareFrame(originSrc, padding, shortSideLen, frame);
+    detectBoxes(NULL, NULL, frame, boxScoreThresh, boxThresh, unClipRatio);
+    return frame;
+}
+
+OcrResult OcrLite::recognizeStage(OcrFrame &frame, bool doAngle, bool mostAngle) {
+    if (frame.src.empty()) return OcrResult{};
+    return recognizeBoxes(NULL, NULL, frame, doAngle, mostAngle);
 }
 
 std::vector<cv::Mat> OcrLite::getPartImages(cv::Mat &src, std::vector<TextBox> &textBoxes,
                                             const char *path, const char *imgName) {
-    std::vector<cv::Mat> partImages;
+    // 各文本框的裁剪互不依赖（只读 src），并行提取；调试输出仍按顺序进行
+    std::vector<cv::Mat> partImages(textBoxes.size());
+    cv::parallel_for_(cv::Range(0, (int) textBoxes.size()), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i)
+            partImages[i] = getRotateCropImage(src, textBoxes[i].boxPoint);
+    });
     for (size_t i = 0; i < textBoxes.size(); ++i) {
-        cv::Mat partImg = getRotateCropImage(src, textBoxes[i].boxPoint);
+        cv::Mat &partImg = partImages[i];
         if (partImg.empty())
             fprintf(stderr, "文本框[%zu] 提取为空\n", i);
-        partImages.emplace_back(partImg);
-        if (!g_partImagesSavePath.empty()) {
-            std::string cropPath = g_partImagesSavePath + "/part_" + std::to_string(i) + ".png";
+        if (!partImagesSavePath_.empty()) {
+            std::string cropPath = partImagesSavePath_ + "/part_" + std::to_string(i) + ".png";
             saveImg(partImg, cropPath.c_str());
         }
         if (isOutputPartImg && path != NULL && imgName != NULL) {
@@ -190,12 +297,68 @@ std::vector<cv::Mat> OcrLite::getPartImages(cv::Mat &src, std::vector<TextBox> &
     return partImages;
 }
 
-OcrResult OcrLite::detect(const char *path, const char *imgName,
-                          cv::Mat &src, cv::Rect &originRect, ScaleParam &scale,
-                          float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle) {
+/**
+ * @brief 沿一个方向划分分块起点（原图像素）：步长为 tile - overlap，最后一块贴齐末端，所有分块等大
+ */
+static std::vector<int> tileStarts(int length, int tile, int overlap) {
+    std::vector<int> starts;
+    int step = (std::max)(tile - overlap, 32);
+    for (int pos = 0;; pos += step) {
+        if (pos + tile >= length) {
+            starts.push_back((std::max)(0, length - tile));
+            break;
+        }
+        starts.push_back(pos);
+    }
+    return starts;
+}
+
+std::vector<TextBox> OcrLite::detectTiles(cv::Mat &src, float boxScoreThresh,
+                                          float boxThresh, float unClipRatio, bool swapRB) {
+    // 分块在原图分辨率上切分并按原分辨率送入 det，不受 short_side_len 缩放影响，小字保持原大小；
+    // 分块等大，det 输入形状固定，工作区与绑定在分块间复用；DbNet 算子内线程负责占满各核
+    int tileWidth = (std::min)(detTileSize_, src.cols);
+    int tileHeight = (std::min)(detTileSize_, src.rows);
+    int overlap = (std::min)(detTileOverlap_, detTileSize_ / 2);
+    std::vector<int> xs = tileStarts(src.cols, tileWidth, overlap);
+    std::vector<int> ys = tileStarts(src.rows, tileHeight, overlap);
+    // 分块边长已是 32 的倍数；只有比分块短的整图边需要向下取整，略微缩小
+    int dstWidth = (std::max)(32, tileWidth / 32 * 32);
+    int dstHeight = (std::max)(32, tileHeight / 32 * 32);
+    Logger("DetTiles(%dx%d, tile:%dx%d, overlap:%d)\n", (int) xs.size(), (int) ys.size(),
+           tileWidth, tileHeight, overlap);
+
+    std::vector<TextBox> boxes;
+    std::vector<int> tileIds;
+    for (size_t ty = 0; ty < ys.size(); ++ty) {
+        for (size_t tx = 0; tx < xs.size(); ++tx) {
+            // 分块直接引用原图 ROI，不复制；框由分块坐标加分块偏移换算回整图
+            int x0 = xs[tx];
+            int y0 = ys[ty];
+            cv::Mat tile = src(cv::Rect(x0, y0, tileWidth, tileHeight));
+            ScaleParam tileScale{tile.cols, tile.rows, dstWidth, dstHeight,
+                                 (float) dstWidth / (float) tile.cols, (float) dstHeight / (float) tile.rows};
+            std::vector<TextBox> tileBoxes = dbNet.getTextBoxes(tile, tileScale, boxScoreThresh, boxThresh,
+                                                                unClipRatio, swapRB);
+            int tileId = (int) (ty * xs.size() + tx);
+            for (TextBox &box : tileBoxes) {
+                for (cv::Point &p : box.boxPoint) {
+                    p.x += x0;
+                    p.y += y0;
+                }
+                boxes.emplace_back(std::move(box));
+                tileIds.push_back(tileId);
+            }
+        }
+    }
+    return mergeTileBoxes(boxes, tileIds);
+}
 
-    cv::Mat textBoxPaddingImg = src.clone();
-    int thickness = getThickness(src);
+void OcrLite::detectBoxes(const char *path, const char *imgName, OcrFrame &frame,
+                          float boxScoreThresh, float boxThresh, float unClipRatio) {
+    applyDetSessionOptions();
+    cv::Mat &src = frame.src;
+    ScaleParam &scale = frame.scale;
 
     Logger("=====Start detect=====\n");
     Logger("ScaleParam(sw:%d,sh:%d,dw:%d,dh:%d,%f,%f)\n", scale.srcWidth, scale.srcHeight,
@@ -203,12 +366,15 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
            scale.ratioWidth, scale.ratioHeight);
 
     Logger("---------- step: dbNet getTextBoxes ----------\n");
-    double startTime = getCurrentTime();
-    std::vector<TextBox> textBoxes = dbNet.getTextBoxes(src, scale, boxScoreThresh, boxThresh, unClipRatio);
-    double endDbNetTime = getCurrentTime();
-    double dbNetTime = endDbNetTime - startTime;
-    Logger("dbNetTime(%fms)\n", dbNetTime);
-
+    frame.startTime = getCurrentTime();
+    if (detTileSize_ > 0 && (src.cols > detTileSize_ || src.rows > detTileSize_))
+        frame.textBoxes = detectTiles(src, boxScoreThresh, boxThresh, unClipRatio, frame.swapRB);
+    else
+        frame.textBoxes = dbNet.getTextBoxes(src, scale, boxScoreThresh, boxThresh, unClipRatio, frame.swapRB);
+    frame.dbNetTime = getCurrentTime() - frame.startTime;
+    Logger("dbNetTime(%fms)\n", frame.dbNetTime);
+
+    std::vector<TextBox> &textBoxes = frame.textBoxes;
     for (int i = 0; i < textBoxes.size(); ++i) {
         Logger("TextBox[%d](+padding)[score(%f),[x: %d, y: %d], [x: %d, y: %d], [x: %d, y: %d], [x: %d, y: %d]]\n", i,
                textBoxes[i].score,
@@ -218,34 +384,69 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
                textBoxes[i].boxPoint[3].x, textBoxes[i].boxPoint[3].y);
     }
 
-    Logger("---------- step: drawTextBoxes ----------\n");
-    drawTextBoxes(textBoxPaddingImg, textBoxes, thickness);
+    if (drawResultImage_ || isOutputResultImg) {
+        Logger("---------- step: drawTextBoxes ----------\n");
+        // 画框结果图统一为 BGR；源图已是 BGR 时复制一份，避免在（可能是调用方的）源图上画框
+        frame.boxImg = toBgr(src, !frame.swapRB);
+        if (frame.boxImg.data == src.data) frame.boxImg = src.clone();
+        drawTextBoxes(frame.boxImg, textBoxes, getThickness(src));
+    }
+
+    // 融合裁剪只记录几何，cls/rec 从原图直接采样；需要保存裁剪块（调试）时仍生成裁剪图
+    if (fusedCrop_ && partImagesSavePath_.empty() && !isOutputPartImg) {
+        frame.crops.resize(textBoxes.size());
+        for (size_t i = 0; i < textBoxes.size(); ++i) {
+            frame.crops[i] = makeTextCrop(src, textBoxes[i].boxPoint);
+            if (frame.crops[i].size.empty())
+                fprintf(stderr, "文本框[%zu] 提取为空\n", i);
+        }
+        return;
+    }
 
     //---------- getPartImages ----------
-    std::vector<cv::Mat> partImages = getPartImages(src, textBoxes, path, imgName);
+    frame.partImages = getPartImages(src, textBoxes, path, imgName);
+}
+
+/**
+ * @brief 按 cls 结果旋转 180°：融合裁剪只置标志（采样时一并旋转），否则旋转裁剪图
+ */
+static void applyAngles(std::vector<cv::Mat> &partImages, std::vector<TextCrop> &crops,
+                        const std::vector<Angle> &angles) {
+    //Rotate partImgs：与 OnnxOCR 一致，label_list=['0','180'] 即 index 0=0°、index 1=180°
+    // 仅当分类为 180°（index==1）时旋转，否则会误把正放的文字旋转成倒的导致 rec 无法识别
+    for (size_t i = 0; i < angles.size(); ++i) {
+        if (angles[i].index != 1) continue;
+        if (i < crops.size())
+            crops[i].rotate180 = true;
+        else
+            partImages[i] = matRotateClockWise180(partImages[i]);
+    }
+}
+
+OcrResult OcrLite::recognizeBoxes(const char *path, const char *imgName, OcrFrame &frame,
+                                  bool doAngle, bool mostAngle) {
+    applyRecSessionOptions();
+    MatCropSource matCrops(frame.partImages);
+    QuadCropSource quadCrops(frame.crops);
+    const CropSource &crops = frame.crops.empty() ? (const CropSource &) matCrops : quadCrops;
 
     Logger("---------- step: angleNet getAngles ----------\n");
     std::vector<Angle> angles;
-    angles = angleNet.getAngles(partImages, path, imgName, doAngle, mostAngle);
+    angles = angleNet.getAngles(crops, path, imgName, doAngle, mostAngle, frame.swapRB);
 
     //Log Angles
     for (int i = 0; i < angles.size(); ++i) {
         Logger("angle[%d][index(%d), score(%f), time(%fms)]\n", i, angles[i].index, angles[i].score, angles[i].time);
     }
 
-    //Rotate partImgs：与 OnnxOCR 一致，label_list=['0','180'] 即 index 0=0°、index 1=180°
-    // 仅当分类为 180°（index==1）时旋转，否则会误把正放的文字旋转成倒的导致 rec 无法识别
-    for (int i = 0; i < partImages.size(); ++i) {
-        if (angles[i].index == 1) {
-            partImages.at(i) = matRotateClockWise180(partImages[i]);
-        }
-    }
+    applyAngles(frame.partImages, frame.crops, angles);
 
     // cpp_projects/OcrLiteOnnx 不进行 RGB->BGR 转换，rec 模型接收 RGB
     // Python OnnxOCR 使用 BGR（cv2.imread 直接裁剪），但 PPOCRv4 SVTR_LCNet 可能训练时用 RGB
     // 实测：传递 RGB 给 rec 模型（与 OcrLiteOnnx 一致）可正确识别
+    // 裁剪块保持源图通道顺序，BGR 时由 CrnnNet 归一化交换为 RGB，模型输入与之前一致
     Logger("---------- step: crnnNet getTextLine ----------\n");
-    std::vector<TextLine> textLines = crnnNet.getTextLines(partImages, path, imgName);
+    std::vector<TextLine> textLines = crnnNet.getTextLines(crops, path, imgName, frame.swapRB);
     //Log TextLines
     for (int i = 0; i < textLines.size(); ++i) {
         Logger("textLine[%d](%s)\n", i, textLines[i].text.c_str());
@@ -261,8 +462,16 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
         Logger("crnnTime[%d](%fms)\n", i, textLines[i].time);
     }
 
+    return assembleResult(path, imgName, frame, angles.data(), textLines.data());
+}
+
+OcrResult OcrLite::assembleResult(const char *path, const char *imgName, OcrFrame &frame,
+                                  const Angle *angles, const TextLine *textLines) {
+    std::vector<TextBox> &textBoxes = frame.textBoxes;
+    cv::Rect &originRect = frame.originRect;
+
     std::vector<TextBlock> textBlocks;
-    for (int i = 0; i < textLines.size(); ++i) {
+    for (int i = 0; i < textBoxes.size(); ++i) {
         std::vector<cv::Point> boxPoint = std::vector<cv::Point>(4);
         int padding = originRect.x;//padding conversion
         boxPoint[0] = cv::Point(textBoxes[i].boxPoint[0].x - padding, textBoxes[i].boxPoint[0].y - padding);
@@ -276,22 +485,23 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
     }
 
     double endTime = getCurrentTime();
-    double fullTime = endTime - startTime;
+    double fullTime = endTime - frame.startTime;
     Logger("=====End detect=====\n");
     Logger("FullDetectTime(%fms)\n", fullTime);
 
-    //cropped to original size
-    cv::Mat rgbBoxImg, textBoxImg;
+    //cropped to original size (already BGR)；未画框时为空
+    cv::Mat textBoxImg;
 
-    if (originRect.x > 0 && originRect.y > 0) {
-        textBoxPaddingImg(originRect).copyTo(rgbBoxImg);
-    } else {
-        rgbBoxImg = textBoxPaddingImg;
+    if (!frame.boxImg.empty()) {
+        if (originRect.x > 0 && originRect.y > 0) {
+            frame.boxImg(originRect).copyTo(textBoxImg);
+        } else {
+            textBoxImg = frame.boxImg;
+        }
     }
-    cvtColor(rgbBoxImg, textBoxImg, cv::COLOR_RGB2BGR);//convert to BGR for Output Result Img
 
     //Save result.jpg
-    if (isOutputResultImg) {
+    if (isOutputResultImg && !textBoxImg.empty() && path != NULL && imgName != NULL) {
         std::string resultImgFile = getResultImgFilePath(path, imgName);
         imwrite(resultImgFile, textBoxImg);
     }
@@ -302,5 +512,104 @@ OcrResult OcrLite::detect(const char *path, const char *imgName,
         strRes.append("\n");
     }
 
-    return OcrResult{dbNetTime, textBlocks, textBoxImg, fullTime, strRes};
-}
\ No newline at end of file
+    return OcrResult{frame.dbNetTime, textBlocks, textBoxImg, fullTime, strRes};
+}
+
+// detectBatch 每段最多包含的源图像素数：段内所有帧（融合裁剪时含整图）识别完才释放
+static const size_t kBatchChunkPixels = (size_t) 32 << 20;
+
+std::vector<OcrResult> OcrLite::detectBatch(const std::vector<cv::Mat> &mats,
+                                            int padding, int shortSideLen,
+                                            float boxScoreThresh, float boxThresh, float unClipRatio,
+                                            bool doAngle, bool mostAngle, const std::vector<bool> *rgbOrder) {
+    // 按像素预算分段处理，峰值内存只与段大小有关，与批大小无关；单张超出预算的图单独成段
+    std::vector<OcrResult> results;
+    results.reserve(mats.size());
+    size_t begin = 0;
+    while (begin < mats.size()) {
+        size_t end = begin + 1;
+        size_t pixels = mats[begin].total();
+        while (end < mats.size() && pixels + mats[end].total() <= kBatchChunkPixels) {
+            pixels += mats[end].total();
+            ++end;
+        }
+        std::vector<OcrResult> chunk = detectBatchChunk(mats, begin, end, padding, shortSideLen, boxScoreThresh,
+                                                        boxThresh, unClipRatio, doAngle, mostAngle, rgbOrder);
+        for (OcrResult &result : chunk) results.emplace_back(std::move(result));
+        begin = end;
+    }
+    return results;
+}
+
+std::vector<OcrResult> OcrLite::detectBatchChunk(const std::vector<cv::Mat> &mats, size_t begin, size_t end,
+                                                 int padding, int shortSideLen,
+                                                 float boxScoreThresh, float boxThresh, float unClipRatio,
+                                                 bool doAngle, bool mostAngle, const std::vector<bool> *rgbOrder) {
+    size_t imageCount = end - begin;
+    std::vector<OcrFrame> frames;
+    frames.reserve(imageCount);
+    std::vector<bool> detected(imageCount, false);
+    bool anyBgr = false;
+    for (size_t i = 0; i < imageCount; ++i) {
+        size_t index = begin + i;
+        bool rgb = rgbOrder != NULL && index < rgbOrder->size() && (*rgbOrder)[index];
+        frames.push_back(detectStage(mats[index], padding, shortSideLen, boxScoreThresh, boxThresh, unClipRatio, rgb));
+        OcrFrame &frame = frames.back();
+        detected[i] = !frame.src.empty();
+        if (detected[i] && frame.swapRB) anyBgr = true;
+        // 裁剪图是独立副本，外扩白边后的整图（及预处理结果）不再需要，立即释放；融合裁剪仍要从整图采样
+        if (frame.crops.empty()) frame.src.release();
+    }
+    // 合并后的批只有一种通道顺序：RGB 与 BGR 混合时把 RGB 图的裁剪块（而非整图）转为 BGR；
+    // 融合裁剪没有裁剪块，只能转换该图的原图
+    bool swapRB = anyBgr;
+    for (size_t i = 0; i < imageCount && anyBgr; ++i) {
+        if (frames[i].swapRB) continue;
+        for (cv::Mat &part : frames[i].partImages) {
+            if (part.channels() >= 3) cvtColor(part, part, part.channels() == 4 ? cv::COLOR_RGBA2BGRA : cv::COLOR_RGB2BGR);
+        }
+        if (!frames[i].crops.empty() && frames[i].src.channels() >= 3) {
+            cv::Mat bgrSrc;
+            cvtColor(frames[i].src, bgrSrc, frames[i].src.channels() == 4 ? cv::COLOR_RGBA2BGRA : cv::COLOR_RGB2BGR);
+            for (TextCrop &crop : frames[i].crops) {
+                if (!crop.src.empty()) crop.src = bgrSrc;
+            }
+            // 裁剪块只引用转换后的整图
+            frames[i].src.release();
+        }
+    }
+
+    // 段内所有图的裁剪块合并后一起分类/识别，识别批按宽高比跨图分组，批更满
+    // 同一次调用的所有帧要么都是裁剪图，要么都是融合裁剪（由 fusedCrop_ 决定）
+    std::vector<size_t> offsets(imageCount + 1, 0);
+    std::vector<cv::Mat> partImages;
+    std::vector<TextCrop> textCrops;
+    for (size_t i = 0; i < imageCount; ++i) {
+        offsets[i] = partImages.size() + textCrops.size();
+        for (cv::Mat &part : frames[i].partImages) partImages.emplace_back(std::move(part));
+        for (TextCrop &crop : frames[i].crops) textCrops.emplace_back(std::move(crop));
+        frames[i].partImages.clear();
+        frames[i].crops.clear();
+        frames[i].src.release();
+    }
+    offsets[imageCount] = partImages.size() + textCrops.size();
+    Logger("=====Batch detect: %zu images, %zu text boxes=====\n", imageCount, offsets[imageCount]);
+
+    MatCropSource matCrops(partImages);
+    QuadCropSource quadCrops(textCrops);
+    const CropSource &crops = textCrops.empty() ? (const CropSource &) matCrops : quadCrops;
+
+    applyRecSessionOptions();
+    // 多数投票（及抽样）按图分段进行，与逐张 detect 的结果一致
+    std::vector<Angle> angles = angleNet.getAngles(crops, offsets, doAngle, mostAngle, swapRB);
+    applyAngles(partImages, textCrops, angles);
+
+    std::vector<TextLine> textLines = crnnNet.getTextLines(crops, NULL, NULL, swapRB);
+
+    std::vector<OcrResult> results(imageCount);
+    for (size_t i = 0; i < imageCount; ++i) {
+        if (!detected[i]) continue;
+        results[i] = assembleResult(NULL, NULL, frames[i], angles.data() + offsets[i], textLines.data() + offsets[i]);
+    }
+    return results;
+}
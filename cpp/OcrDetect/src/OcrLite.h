@@ -7,6 +7,7 @@
 #include "DbNet.h"
 #include "AngleNet.h"
 #include "CrnnNet.h"
+#include <mutex>
 
 class OcrLite {
 public:
@@ -16,8 +17,107 @@ public:
 
     void setNumThread(int numOfThread);
 
+    /**
+     * @brief 分别设置 det/cls/rec 的算子内线程数，<=0 的项保持不变
+     * 会话已创建时只记录变化，下次使用该会话前（det / rec 阶段开始时）合并为一次重建；
+     * 参数未变化或启用全局线程池时为空操作
+     */
+    void setModelThreads(int detThreads, int clsThreads, int recThreads);
+
+    /**
+     * @brief 设置 ORT 线程池空闲时是否自旋（默认开启），重建规则同 setModelThreads
+     */
+    void setThreadSpinning(bool allow);
+
+    /**
+     * @brief 设置方向分类批大小，多个裁剪块打包成一次推理
+     */
+    void setClsBatchNum(int batchNum);
+
+    /**
+     * @brief 设置识别批大小，按宽高比分组后每批一次推理
+     */
+    void setRecBatchNum(int batchNum);
+
+    /**
+     * @brief 设置优化后模型缓存目录（det/cls/rec 共用），须在 initModels 前调用，空字符串表示不缓存
+     */
+    void setModelCacheDir(const std::string &dir);
+
+    /**
+     * @brief 从只读内存映射加载模型（det/cls/rec），须在 initModels 前调用
+     * 配合优化模型缓存（ORT 格式）时同机多进程共享权重物理页
+     */
+    void setUseMmap(bool use);
+
+    /**
+     * @brief 融合裁剪（默认关闭）：不生成原尺寸裁剪图，cls/rec 由原图按合成单应矩阵一次采样到输入尺寸，
+     * 透视校正、竖排旋转、180° 旋转与缩放在同一次双线性采样中完成；
+     * 省去每个文本块的裁剪、旋转与缩放中间图，结果与逐步处理（双三次校正 + 双线性缩放）有细微差异
+     * 保存裁剪块（调试）时自动回退为逐步处理
+     */
+    void setFusedCrop(bool enable) { fusedCrop_ = enable; }
+
+    /**
+     * @brief 分块检测（默认关闭）：外扩白边后的原图任一边超过 tileSize 时，按原分辨率切成重叠的等大分块逐块检测
+     * （不再按 shortSideLen 缩小整图），再合并接缝两侧的文本框并去除重叠区内的重复框；
+     * 显存/内存占用只与分块大小有关，大图上的小字不会因整体缩小而丢失
+     * @param tileSize 分块边长（原图像素，向下取整为 32 的倍数），<=0 关闭
+     * @param overlap  相邻分块重叠宽度（原图像素，最多为分块边长的一半），应大于最大文字高度
+     */
+    void setDetTiling(int tileSize, int overlap);
+
+    /**
+     * @brief DB 后处理改用连通域快速路径（默认关闭）：一次标记收集各连通域统计与得分和，
+     * 矩形解析外扩代替 Clipper，各连通域并行求框；得分为连通域内概率均值，与默认流程略有差异
+     */
+    void setFastDbPostprocess(bool enable) { dbNet.setFastPostprocess(enable); }
+
+    /**
+     * @brief DB 框得分改用外接矩形均值（默认关闭），由每帧一次的积分图 O(1) 求得，代替掩码求轮廓多边形内均值
+     */
+    void setDbRectScore(bool enable) { dbNet.setRectScore(enable); }
+
+    /**
+     * @brief DB 框得分改用逐行扫描轮廓多边形（默认关闭），不分配掩码；边界像素与 fillPoly 可能相差一个像素
+     */
+    void setDbScanlineScore(bool enable) { dbNet.setScanlineScore(enable); }
+
+    /**
+     * @brief det 输入形状分桶（默认关闭）：缩放后的宽、高各自向上补齐到 sizes 中的某个边长，
+     * 补齐区域填充后在后处理中屏蔽；det 只出现少数几种输入形状，首次遇到新形状时的延迟尖峰只在预热时发生
+     * 模型已加载时立即预热尚未执行过的桶形状（sizes.size()² 种），否则在 initModels 中预热；
+     * 线程参数变化重建 det 会话后自动重新预热
+     * @param sizes 桶边长（det 输入像素，向上取整为 32 的倍数），空表示关闭
+     */
+    void setDetShapeBuckets(const std::vector<int> &sizes);
+
+    /**
+     * @brief 长行分窗识别（默认关闭）：缩放到 rec 输入高度后宽于 windowWidth 的文本块切成重叠的等宽窗口，
+     * 与其他文本块一起组批识别，再按时间步拼接窗口结果；rec 张量宽度与行长无关
+     * @param windowWidth 窗口宽度（rec 输入像素，高 48），<=0 关闭
+     * @param overlap     相邻窗口重叠宽度（rec 输入像素，最多为窗口宽度的一半）
+     */
+    void setRecLineSplit(int windowWidth, int overlap) { crnnNet.setLongLineSplit(windowWidth, overlap); }
+
+    /**
+     * @brief 多数方向抽样（默认关闭）：mostAngle 时每张图只按面积从大到小分类最多 maxSamples 个文本块，
+     * 投票结果确定后提前停止，结果作用于该图所有文本块；方向一致的页面只需几次 cls 推理
+     * @param maxSamples 每张图最多分类的文本块数，<=0 关闭
+     */
+    void setClsSampling(int maxSamples) { angleNet.setMostAngleSampling(maxSamples); }
+
+    /**
+     * @param isResultImg 保存画框结果图（detect(path, imgName, ...) 时），隐含启用画框
+     */
     void initLogger(bool isConsole, bool isPartImg, bool isResultImg);
 
+    /**
+     * @brief 是否生成 OcrResult::boxImg（默认关闭）
+     * 关闭时 detect 不复制整图、不画框，只返回文本块；需要可视化时再开启
+     */
+    void setDrawResultImage(bool enable) { drawResultImage_ = enable; }
+
     void enableResultTxt(const char *path, const char *imgName);
     
     /**
@@ -42,23 +142,63 @@ public:
     bool initModels(const std::string &detPath, const std::string &clsPath,
                     const std::string &recPath, const std::string &keysPath);
 
+    /**
+     * @brief 输出日志到控制台 / 结果文本；流水线模式下 det 与 rec 线程会同时调用，整行写入加锁
+     */
     void Logger(const char *format, ...);
 
     OcrResult detect(const char *path, const char *imgName,
                      int padding, int shortSideLen,
                      float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle);
 
+    /**
+     * @param mat      8 位 1/3/4 通道图，可为引用调用方缓冲区的 Mat 头（含行步长），不会被修改
+     * @param rgbOrder 3/4 通道输入为 RGB(A) 顺序时为 true，默认 BGR(A)
+     */
     OcrResult detect(const cv::Mat &mat,
                      int padding, int shortSideLen,
-                     float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle);
+                     float boxScoreThresh, float boxThresh, float unClipRatio, bool doAngle, bool mostAngle,
+                     bool rgbOrder = false);
+
+    /**
+     * @brief det 阶段：外扩白边、DbNet 检测并裁剪文本块，只使用 det 会话
+     * 不做整图颜色转换（启用预处理时除外），通道顺序记录在 frame.swapRB；输入为空时返回 src 为空的帧
+     */
+    OcrFrame detectStage(const cv::Mat &mat, int padding, int shortSideLen,
+                         float boxScoreThresh, float boxThresh, float unClipRatio, bool rgbOrder = false);
+
+    /**
+     * @brief cls/rec 阶段：方向分类、旋转、识别并组装结果，只使用 cls/rec 会话
+     * 与 detectStage 不共享会话，可在两个线程中分别处理相邻帧（detect = detectStage + recognizeStage）
+     */
+    OcrResult recognizeStage(OcrFrame &frame, bool doAngle, bool mostAngle);
+
+    /**
+     * @brief 多图批量识别：逐张 det 后把所有图的裁剪块合并，一起做批量 cls/rec，再按图拆分结果
+     * 小图多时识别批更满、推理调用更少；mostAngle 投票仍按图分别进行
+     * 按源图像素数分段（每段约 32M 像素）依次处理，段内帧识别完即释放，峰值内存不随批大小增长
+     * @param rgbOrder 与 mats 一一对应的通道顺序（true 为 RGB(A)），NULL 表示全部为 BGR(A)
+     * @return 与 mats 一一对应，空图对应空结果
+     */
+    std::vector<OcrResult> detectBatch(const std::vector<cv::Mat> &mats,
+                                       int padding, int shortSideLen,
+                                       float boxScoreThresh, float boxThresh, float unClipRatio,
+                                       bool doAngle, bool mostAngle, const std::vector<bool> *rgbOrder = NULL);
 
 private:
     bool enablePreprocess_ = false;  // 默认禁用: Python OnnxOCR 无预处理，CLAHE 会影响 rec 模型识别
+    std::string preprocessSavePath_;  // 预处理图像保存路径（调试用），按实例保存，多实例并发互不影响
+    std::string partImagesSavePath_;  // 裁剪块保存目录（非空则保存 part_0.png, part_1.png, ...）
     bool isOutputConsole = false;
     bool isOutputPartImg = false;
     bool isOutputResultTxt = false;
     bool isOutputResultImg = false;
+    bool drawResultImage_ = false;  // 生成画框结果图（整图复制 + 画框），C API 不返回该图，默认关闭
+    bool fusedCrop_ = false;  // 融合裁剪（setFusedCrop）
+    int detTileSize_ = 0;  // 分块检测的分块边长（det 输入像素），0 表示不分块
+    int detTileOverlap_ = 128;  // 相邻分块重叠宽度（det 输入像素）
     FILE *resultTxt;
+    std::mutex logMutex;  // 保证多线程日志按行完整输出
     DbNet dbNet;
     AngleNet angleNet;
     CrnnNet crnnNet;
@@ -66,10 +206,40 @@ private:
     std::vector<cv::Mat> getPartImages(cv::Mat &src, std::vector<TextBox> &textBoxes,
                                        const char *path, const char *imgName);
 
-    OcrResult detect(const char *path, const char *imgName,
-                     cv::Mat &src, cv::Rect &originRect, ScaleParam &scale,
-                     float boxScoreThresh = 0.6f, float boxThresh = 0.3f,
-                     float unClipRatio = 2.0f, bool doAngle = true, bool mostAngle = true);
+    /**
+     * @brief detectBatch 的一段：mats[begin, end) 逐张 det 后合并做 cls/rec；
+     * 裁剪图模式下每帧取出裁剪块后立即释放整图，融合裁剪时整图保留到本段识别结束
+     */
+    std::vector<OcrResult> detectBatchChunk(const std::vector<cv::Mat> &mats, size_t begin, size_t end,
+                                            int padding, int shortSideLen,
+                                            float boxScoreThresh, float boxThresh, float unClipRatio,
+                                            bool doAngle, bool mostAngle, const std::vector<bool> *rgbOrder);
+
+    /**
+     * @brief 应用挂起的 det 会话参数，重建后重新预热分桶形状；在 det 阶段所在线程调用
+     */
+    void applyDetSessionOptions();
+
+    /** @brief 应用挂起的 cls/rec 会话参数；在 cls/rec 阶段所在线程调用 */
+    void applyRecSessionOptions();
+
+    /**
+     * @brief 在原图分辨率上分块运行 DbNet 并合并接缝处的文本框，返回外扩白边坐标系下的框
+     */
+    std::vector<TextBox> detectTiles(cv::Mat &src, float boxScoreThresh,
+                                     float boxThresh, float unClipRatio, bool swapRB);
+
+    void detectBoxes(const char *path, const char *imgName, OcrFrame &frame,
+                     float boxScoreThresh, float boxThresh, float unClipRatio);
+
+    OcrResult recognizeBoxes(const char *path, const char *imgName, OcrFrame &frame,
+                             bool doAngle, bool mostAngle);
+
+    /**
+     * @brief 由方向与识别结果组装 OcrResult（angles / textLines 与 frame.textBoxes 一一对应）
+     */
+    OcrResult assembleResult(const char *path, const char *imgName, OcrFrame &frame,
+                             const Angle *angles, const TextLine *textLines);
 };
 
 #endif //__OCR_LITE_H__
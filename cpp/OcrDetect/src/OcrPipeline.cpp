@@ -0,0 +1,64 @@
+#include "OcrPipeline.h"
+
+OcrPipeline::OcrPipeline(OcrLite &ocr, int queueDepth)
+        : ocr(ocr), detQueue(queueDepth), recQueue(queueDepth), outQueue(queueDepth) {
+    detThread = std::thread(&OcrPipeline::detLoop, this);
+    recThread = std::thread(&OcrPipeline::recLoop, this);
+}
+
+OcrPipeline::~OcrPipeline() {
+    // 全部关闭并丢弃：即使无人取结果（outQueue 满），阶段线程也能退出
+    detQueue.close(true);
+    recQueue.close(true);
+    outQueue.close(true);
+    detThread.join();
+    recThread.join();
+}
+
+long long OcrPipeline::submit(Request &&request, bool blocking) {
+    // 序号分配与入队在同一把锁内完成，保证序号顺序即队列顺序
+    std::lock_guard<std::mutex> lock(submitMutex);
+    DetJob job{nextSeq, std::move(request)};
+    if (!detQueue.push(std::move(job), blocking)) return -1;
+    return nextSeq++;
+}
+
+bool OcrPipeline::poll(Output &out, int timeoutMs) {
+    return outQueue.pop(out, timeoutMs);
+}
+
+void OcrPipeline::detLoop() {
+    DetJob job;
+    while (detQueue.pop(job)) {
+        const Request &r = job.request;
+        RecJob rec{job.seq, OcrFrame{}, r.doAngle, r.mostAngle, std::string()};
+        try {
+            rec.frame = ocr.detectStage(r.image, r.padding, r.shortSideLen,
+                                        r.boxScoreThresh, r.boxThresh, r.unClipRatio);
+        } catch (const std::exception &e) {
+            rec.error = e.what();
+        }
+        job.request.image.release();
+        if (!recQueue.push(std::move(rec))) break;
+    }
+    recQueue.close();
+}
+
+void OcrPipeline::recLoop() {
+    RecJob job;
+    while (recQueue.pop(job)) {
+        Output out;
+        out.seq = job.seq;
+        out.error = job.error;
+        if (out.error.empty()) {
+            try {
+                out.result = ocr.recognizeStage(job.frame, job.doAngle, job.mostAngle);
+            } catch (const std::exception &e) {
+                out.error = e.what();
+            }
+        }
+        job.frame = OcrFrame{};
+        if (!outQueue.push(std::move(out))) break;
+    }
+    outQueue.close();
+}
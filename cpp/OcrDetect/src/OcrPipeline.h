@@ -0,0 +1,150 @@
+#ifndef __OCR_PIPELINE_H__
+#define __OCR_PIPELINE_H__
+
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "OcrLite.h"
+
+/**
+ * 有界阻塞队列：队列满时 push 阻塞（或非阻塞失败），为空时 pop 等待；
+ * close 后 push 立即失败，pop 取完剩余元素后返回 false
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity < 1 ? 1 : capacity) {}
+
+    bool push(T &&item, bool blocking = true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (blocking)
+            notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed || items.size() >= capacity) return false;
+        items.push_back(std::move(item));
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /** @param timeoutMs <0 无限等待，0 不等待 */
+    bool pop(T &item, int timeoutMs = -1) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto ready = [this] { return closed || !items.empty(); };
+        if (timeoutMs < 0)
+            notEmpty.wait(lock, ready);
+        else if (!notEmpty.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready))
+            return false;
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    /** @param discard true 时丢弃尚未取出的元素 */
+    void close(bool discard = false) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            if (discard) items.clear();
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+/**
+ * 多帧流水线：det 线程与 cls/rec 线程通过有界队列相连，
+ * 第 N 帧做 cls/rec 时第 N+1 帧已在做 det
+ *
+ * 单个 det 线程与单个 rec 线程均按 FIFO 处理，结果严格按提交顺序输出；
+ * 任一队列满时上游阻塞，最终反压到 submit，内存占用不随输入速度增长
+ * 运行期间 OcrLite 只能由流水线使用，不可再并发调用其 detect / setter
+ */
+class OcrPipeline {
+public:
+    struct Request {
+        cv::Mat image;
+        int padding = 0;
+        int shortSideLen = 960;
+        float boxScoreThresh = 0.6f;
+        float boxThresh = 0.3f;
+        float unClipRatio = 2.0f;
+        bool doAngle = true;
+        bool mostAngle = true;
+    };
+
+    struct Output {
+        long long seq = -1;
+        OcrResult result;
+        std::string error;  // 非空表示该帧处理失败
+    };
+
+    /**
+     * @param queueDepth 每个阶段队列的容量（帧数）
+     */
+    OcrPipeline(OcrLite &ocr, int queueDepth);
+
+    /** @brief 停止并丢弃未完成的帧 */
+    ~OcrPipeline();
+
+    OcrPipeline(const OcrPipeline &) = delete;
+
+    OcrPipeline &operator=(const OcrPipeline &) = delete;
+
+    /**
+     * @brief 提交一帧，返回从 0 递增的序号
+     * @param blocking 队列满时阻塞等待；false 时立即返回 -1
+     * @return 序号，队列满（非阻塞）或流水线已停止时返回 -1
+     */
+    long long submit(Request &&request, bool blocking);
+
+    /**
+     * @brief 按提交顺序取出下一帧结果
+     * @param timeoutMs <0 无限等待，0 不等待
+     * @return 超时返回 false
+     */
+    bool poll(Output &out, int timeoutMs);
+
+private:
+    struct DetJob {
+        long long seq;
+        Request request;
+    };
+
+    struct RecJob {
+        long long seq;
+        OcrFrame frame;
+        bool doAngle;
+        bool mostAngle;
+        std::string error;
+    };
+
+    OcrLite &ocr;
+    BoundedQueue<DetJob> detQueue;
+    BoundedQueue<RecJob> recQueue;
+    BoundedQueue<Output> outQueue;
+    std::mutex submitMutex;
+    long long nextSeq = 0;
+    std::thread detThread;
+    std::thread recThread;
+
+    void detLoop();
+
+    void recLoop();
+};
+
+
+#endif //__OCR_PIPELINE_H__
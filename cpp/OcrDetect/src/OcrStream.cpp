@@ -0,0 +1,86 @@
+#include "OcrStream.h"
+#include <algorithm>
+#include <climits>
+
+OcrStream::OcrStream(OcrLite &ocr, int width, int type, bool rgbOrder, int bandHeight, int overlap,
+                     const Options &options, BlockCallback callback)
+        : ocr(ocr), width_(width), type_(type), rgbOrder(rgbOrder), options(options), callback(std::move(callback)),
+          prevCommit(LLONG_MIN) {
+    bandHeight = (std::max)(bandHeight, 64);
+    this->overlap = (std::min)((std::max)(overlap, 0), bandHeight / 2);
+    band.create(bandHeight, width, type);
+}
+
+void OcrStream::push(const cv::Mat &rows) {
+    if (finished || rows.empty()) return;
+    CV_Assert(rows.cols == band.cols && rows.type() == band.type());
+    for (int begin = 0; begin < rows.rows;) {
+        int count = (std::min)(rows.rows - begin, band.rows - filled);
+        rows.rowRange(begin, begin + count).copyTo(band.rowRange(filled, filled + count));
+        begin += count;
+        filled += count;
+        if (filled == band.rows) processBand(false);
+    }
+}
+
+bool OcrStream::read(const RowReader &reader) {
+    if (finished) return false;
+    for (;;) {
+        cv::Mat free = band.rowRange(filled, band.rows);
+        int count = reader(free);
+        if (count == 0) return true;
+        if (count < 0 || count > free.rows) return false;
+        filled += count;
+        if (filled == band.rows) processBand(false);
+    }
+}
+
+void OcrStream::finish() {
+    if (finished) return;
+    finished = true;
+    // 只剩上一带的重叠行时也要检测：上边界在重叠区内的框留给了这一带
+    if (filled > 0) processBand(true);
+    band.release();
+}
+
+void OcrStream::processBand(bool last) {
+    cv::Mat view = band.rowRange(0, filled);
+    long long commit = last ? LLONG_MAX : (long long) bandTop + filled - overlap;
+
+    OcrFrame frame = ocr.detectStage(view, options.padding, options.shortSideLen, options.boxScoreThresh,
+                                     options.boxThresh, options.unClipRatio, rgbOrder);
+    if (!frame.src.empty()) {
+        // 只保留上边界落在 (prevCommit, commit] 的框，其余框由相邻带输出
+        size_t kept = 0;
+        for (size_t i = 0; i < frame.textBoxes.size(); ++i) {
+            int top = INT_MAX;
+            for (const cv::Point &p : frame.textBoxes[i].boxPoint) top = (std::min)(top, p.y);
+            long long globalTop = (long long) top - frame.originRect.y + bandTop;
+            if (globalTop <= prevCommit || globalTop > commit) continue;
+            if (kept != i) {
+                frame.textBoxes[kept] = std::move(frame.textBoxes[i]);
+                if (i < frame.partImages.size()) frame.partImages[kept] = std::move(frame.partImages[i]);
+                if (i < frame.crops.size()) frame.crops[kept] = std::move(frame.crops[i]);
+            }
+            ++kept;
+        }
+        frame.textBoxes.resize(kept);
+        if (!frame.partImages.empty()) frame.partImages.resize(kept);
+        if (!frame.crops.empty()) frame.crops.resize(kept);
+
+        OcrResult result = ocr.recognizeStage(frame, options.doAngle, options.mostAngle);
+        for (TextBlock &block : result.textBlocks) {
+            for (cv::Point &p : block.boxPoint) p.y += bandTop;
+        }
+        if (!result.textBlocks.empty() && callback) callback(result.textBlocks);
+    }
+
+    if (last) return;
+    // 底部 overlap 行成为下一带的顶部（overlap 不超过带高一半，源与目标不重叠）
+    int keep = (std::min)(overlap, filled);
+    if (keep > 0)
+        band.rowRange(filled - keep, filled).copyTo(band.rowRange(0, keep));
+    bandTop += filled - keep;
+    filled = keep;
+    prevCommit = commit;
+}
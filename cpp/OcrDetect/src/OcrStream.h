@@ -0,0 +1,94 @@
+#ifndef __OCR_STREAM_H__
+#define __OCR_STREAM_H__
+
+#include <functional>
+#include <vector>
+#include "OcrLite.h"
+
+/**
+ * 流式分带检测：图像按行分批送入，攒满一个带高后检测并识别该带，相邻带重叠 overlap 行
+ *
+ * 每个文本框只归属于上边界所在的带：第 k 带只输出上边界落在 (C[k-1], C[k]] 内的框，
+ * C[k] 为第 k 带底部向上 overlap 行（下一带的起始行）；贴着带顶被截断的框属于上一带，
+ * 上边界在重叠区内的框留给下一带，在下一带中完整可见（文字高度小于 overlap 时）。
+ * 因此跨带边界的框只输出一次，带处理完即回调输出，坐标为整图坐标
+ *
+ * 内存只保留一个带高的像素，与图像总高度无关；运行期间 OcrLite 只能由本对象使用
+ */
+class OcrStream {
+public:
+    struct Options {
+        int padding = 0;
+        int shortSideLen = 0;
+        float boxScoreThresh = 0.6f;
+        float boxThresh = 0.3f;
+        float unClipRatio = 2.0f;
+        bool doAngle = true;
+        bool mostAngle = true;
+    };
+
+    /** @brief 一个带完成后输出其文本块（整图坐标，按带内顺序），可移走其中内容 */
+    typedef std::function<void(std::vector<TextBlock> &blocks)> BlockCallback;
+
+    /**
+     * @brief 行读取：向 dst 写入至多 dst.rows 行（宽度、类型与流一致），返回实际行数，0 表示结束，<0 表示出错
+     */
+    typedef std::function<int(cv::Mat &dst)> RowReader;
+
+    /**
+     * @param width      图像宽度
+     * @param type       8 位 1/3/4 通道类型（CV_8UC1 / CV_8UC3 / CV_8UC4）
+     * @param rgbOrder   3/4 通道为 RGB(A) 顺序时为 true
+     * @param bandHeight 带高（行），不足 64 按 64
+     * @param overlap    相邻带重叠行数，应大于最大文字高度，最多为带高的一半
+     */
+    OcrStream(OcrLite &ocr, int width, int type, bool rgbOrder, int bandHeight, int overlap,
+              const Options &options, BlockCallback callback);
+
+    OcrStream(const OcrStream &) = delete;
+
+    OcrStream &operator=(const OcrStream &) = delete;
+
+    /**
+     * @brief 送入若干行（宽度、类型须与流一致，可为引用调用方缓冲区的 Mat 头），像素复制进带缓冲区
+     * 攒满带高时当场检测并回调
+     */
+    void push(const cv::Mat &rows);
+
+    /**
+     * @brief 由 reader 直接把行读进带缓冲区，直到 reader 返回 0（不调用 finish）
+     * @return false 表示 reader 出错或返回了非法行数
+     */
+    bool read(const RowReader &reader);
+
+    /** @brief 检测剩余的行并输出最后一个带；之后不可再送入 */
+    void finish();
+
+    /** @brief 已送入的总行数 */
+    int rows() const { return bandTop + filled; }
+
+    int width() const { return width_; }
+
+    int type() const { return type_; }
+
+private:
+    OcrLite &ocr;
+    int width_;
+    int type_;
+    bool rgbOrder;
+    int overlap;
+    Options options;
+    BlockCallback callback;
+
+    cv::Mat band;         // 带缓冲区，bandHeight 行
+    int filled = 0;       // 带缓冲区中的有效行数
+    int bandTop = 0;      // 带缓冲区第 0 行在整图中的行号
+    long long prevCommit; // 上一带的归属下界 C[k-1]，首带为无穷小
+    bool finished = false;
+
+    /** @brief 检测当前带并输出归属本带的文本块，非最后一带时把底部 overlap 行移到顶部 */
+    void processBand(bool last);
+};
+
+
+#endif //__OCR_STREAM_H__
@@ -44,10 +44,37 @@ struct OCRLITE_PORT TextBlock {
     double blockTime;
 };
 
+/**
+ * 融合裁剪的文本块：不生成裁剪图，只记录原图与采样变换，cls/rec 按各自输入尺寸一次采样
+ */
+struct TextCrop {
+    cv::Mat src;            // 外扩白边后的原图（共享像素，不复制）
+    cv::Matx33d toSrc;      // 校正后文本块像素坐标 -> 原图像素坐标（已含透视校正与竖排旋转）
+    cv::Size size;          // 校正后尺寸，无效块为空
+    bool rotate180 = false; // 方向分类判定为 180° 时置位，采样时一并旋转
+};
+
+/**
+ * det 阶段的输出：检测框与裁剪块，交给 cls/rec 阶段继续处理（流水线中在阶段线程间传递）
+ */
+struct OcrFrame {
+    cv::Mat src;                      // 外扩白边后的图（1/3/4 通道，可能直接引用调用方缓冲区）
+    cv::Rect originRect;              // 原图在 src 中的区域
+    ScaleParam scale;
+    std::vector<TextBox> textBoxes;
+    std::vector<cv::Mat> partImages;  // 与 textBoxes 一一对应的裁剪块（融合裁剪时为空）
+    std::vector<TextCrop> crops;      // 融合裁剪时与 textBoxes 一一对应，否则为空
+    cv::Mat boxImg;                   // 画框结果图（BGR，外扩白边坐标系），未启用画框时为空
+    bool swapRB = true;               // src 为 BGR 顺序时为 true，归一化时交换为模型所需的 RGB
+    double dbNetTime;
+    double startTime;
+};
+
 struct OCRLITE_PORT OcrResult {
     double dbNetTime;
     std::vector<TextBlock> textBlocks;
-    cv::Mat boxImg;
+    cv::Mat boxImg;  // 画框结果图，仅在 OcrLite::setDrawResultImage(true) 或保存结果图时生成
+
     double detectTime;
     std::string strRes;
 };
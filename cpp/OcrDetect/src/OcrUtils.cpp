@@ -1,9 +1,13 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
 #include <numeric>
 #include <cstring>
 #include <cstdio>
 #include "OcrUtils.h"
+#include "OcrKernels.h"
 #include "clipper.hpp"
 
 double getCurrentTime() {
@@ -87,7 +91,7 @@ void drawTextBox(cv::Mat &boxImg, cv::RotatedRect &rect, int thickness) {
 }
 
 void drawTextBox(cv::Mat &boxImg, const std::vector<cv::Point> &box, int thickness) {
-    auto color = cv::Scalar(255, 0, 0);// R(255) G(0) B(0)
+    auto color = cv::Scalar(0, 0, 255);// B(0) G(0) R(255)，底图为 BGR
     cv::line(boxImg, box[0], box[1], color, thickness);
     cv::line(boxImg, box[1], box[2], color, thickness);
     cv::line(boxImg, box[2], box[3], color, thickness);
@@ -101,8 +105,8 @@ void drawTextBoxes(cv::Mat &boxImg, std::vector<TextBox> &textBoxes, int thickne
 }
 
 cv::Mat matRotateClockWise180(cv::Mat src) {
-    flip(src, src, 0);
-    flip(src, src, 1);
+    // 水平+垂直翻转一次完成，src 为独占的裁剪块时原地进行
+    flip(src, src, -1);
     return src;
 }
 
@@ -112,43 +116,67 @@ cv::Mat matRotateClockWise90(cv::Mat src) {
     return src;
 }
 
-cv::Mat getRotateCropImage(const cv::Mat &src, std::vector<cv::Point> box) {
-    cv::Mat image;
-    src.copyTo(image);
-    std::vector<cv::Point> points = box;
+/**
+ * @brief 竖排文本块（高 >= 1.5 倍宽）逆时针转 90°，与 Python get_rotate_crop_image 一致
+ */
+static cv::Mat rotateVerticalCrop(cv::Mat partImg) {
+    if (float(partImg.rows) >= float(partImg.cols) * 1.5) {
+        cv::Mat srcCopy;
+        cv::transpose(partImg, srcCopy);
+        cv::flip(srcCopy, srcCopy, 0);
+        return srcCopy;
+    }
+    return partImg;
+}
 
+cv::Size getRotateCropSize(const cv::Mat &src, const std::vector<cv::Point> &box, cv::Rect *bounds) {
     int collectX[4] = {box[0].x, box[1].x, box[2].x, box[3].x};
     int collectY[4] = {box[0].y, box[1].y, box[2].y, box[3].y};
-    int left = int(*std::min_element(collectX, collectX + 4));
-    int right = int(*std::max_element(collectX, collectX + 4));
-    int top = int(*std::min_element(collectY, collectY + 4));
-    int bottom = int(*std::max_element(collectY, collectY + 4));
-    if (left < 0 || top < 0 || right > src.cols || bottom > src.rows) {
-        left = std::max(0, left);
-        top = std::max(0, top);
-        right = std::min(src.cols, right);
-        bottom = std::min(src.rows, bottom);
-    }
+    int left = (std::max)(0, *std::min_element(collectX, collectX + 4));
+    int right = (std::min)(src.cols, *std::max_element(collectX, collectX + 4));
+    int top = (std::max)(0, *std::min_element(collectY, collectY + 4));
+    int bottom = (std::min)(src.rows, *std::max_element(collectY, collectY + 4));
     if (right <= left || bottom <= top)
-        return cv::Mat();
-    cv::Mat imgCrop;
-    image(cv::Rect(left, top, right - left, bottom - top)).copyTo(imgCrop);
-
-    for (int i = 0; i < points.size(); i++) {
-        points[i].x -= left;
-        points[i].y -= top;
-    }
+        return cv::Size();
+    if (bounds) *bounds = cv::Rect(left, top, right - left, bottom - top);
 
     // Python: img_crop_width = int(max(norm(p0-p1), norm(p2-p3)))
     //         img_crop_height = int(max(norm(p0-p3), norm(p1-p2)))
-    double w1 = sqrt(pow(points[0].x - points[1].x, 2) + pow(points[0].y - points[1].y, 2));
-    double w2 = sqrt(pow(points[2].x - points[3].x, 2) + pow(points[2].y - points[3].y, 2));
+    double w1 = sqrt(pow(box[0].x - box[1].x, 2) + pow(box[0].y - box[1].y, 2));
+    double w2 = sqrt(pow(box[2].x - box[3].x, 2) + pow(box[2].y - box[3].y, 2));
     int imgCropWidth = int(std::max(w1, w2));
-    double h1 = sqrt(pow(points[0].x - points[3].x, 2) + pow(points[0].y - points[3].y, 2));
-    double h2 = sqrt(pow(points[1].x - points[2].x, 2) + pow(points[1].y - points[2].y, 2));
+    double h1 = sqrt(pow(box[0].x - box[3].x, 2) + pow(box[0].y - box[3].y, 2));
+    double h2 = sqrt(pow(box[1].x - box[2].x, 2) + pow(box[1].y - box[2].y, 2));
     int imgCropHeight = int(std::max(h1, h2));
     if (imgCropWidth <= 0 || imgCropHeight <= 0)
+        return cv::Size();
+    return cv::Size(imgCropWidth, imgCropHeight);
+}
+
+cv::Mat getRotateCropImage(const cv::Mat &src, std::vector<cv::Point> box) {
+    std::vector<cv::Point> points = box;
+
+    // 轴对齐矩形且完全在图内：透视变换退化为整数平移，INTER_CUBIC 采样恰好落在像素上，
+    // 结果与 warpPerspective 逐像素一致，直接复制 ROI 即可
+    if (box[0].y == box[1].y && box[2].y == box[3].y && box[0].x == box[3].x && box[1].x == box[2].x &&
+        box[1].x > box[0].x && box[3].y > box[0].y &&
+        box[0].x >= 0 && box[0].y >= 0 && box[1].x <= src.cols && box[3].y <= src.rows) {
+        cv::Rect rect(box[0].x, box[0].y, box[1].x - box[0].x, box[3].y - box[0].y);
+        return rotateVerticalCrop(src(rect).clone());
+    }
+
+    cv::Rect bounds;
+    cv::Size cropSize = getRotateCropSize(src, box, &bounds);
+    if (cropSize.empty())
         return cv::Mat();
+    int imgCropWidth = cropSize.width, imgCropHeight = cropSize.height;
+    // 外接矩形只取视图（不复制），warpPerspective 的边界复制以该视图为界，结果与复制后再变换一致
+    cv::Mat imgCrop = src(bounds);
+
+    for (int i = 0; i < points.size(); i++) {
+        points[i].x -= bounds.x;
+        points[i].y -= bounds.y;
+    }
 
     cv::Point2f ptsDst[4];
     ptsDst[0] = cv::Point2f(0., 0.);
@@ -170,13 +198,7 @@ cv::Mat getRotateCropImage(const cv::Mat &src, std::vector<cv::Point> box) {
     cv::warpPerspective(imgCrop, partImg, M,
                         cv::Size(imgCropWidth, imgCropHeight),
                         cv::INTER_CUBIC, cv::BORDER_REPLICATE);
-    if (float(partImg.rows) >= float(partImg.cols) * 1.5) {
-        cv::Mat srcCopy = cv::Mat(partImg.rows, partImg.cols, partImg.depth());
-        cv::transpose(partImg, srcCopy);
-        cv::flip(srcCopy, srcCopy, 0);
-        return srcCopy;
-    }
-    return partImg;
+    return rotateVerticalCrop(partImg);
 }
 
 cv::Mat adjustTargetImg(cv::Mat &src, int dstWidth, int dstHeight) {
@@ -184,7 +206,7 @@ cv::Mat adjustTargetImg(cv::Mat &src, int dstWidth, int dstHeight) {
     float scale = (float) dstHeight / (float) src.rows;
     int angleWidth = int((float) src.cols * scale);
     cv::resize(src, srcResize, cv::Size(angleWidth, dstHeight));
-    cv::Mat srcFit = cv::Mat(dstHeight, dstWidth, CV_8UC3, cv::Scalar(255, 255, 255));
+    cv::Mat srcFit = cv::Mat(dstHeight, dstWidth, src.type(), cv::Scalar(255, 255, 255, 255));
     if (angleWidth < dstWidth) {
         cv::Rect rect(0, 0, srcResize.cols, srcResize.rows);
         srcResize.copyTo(srcFit(rect));
@@ -199,9 +221,8 @@ bool cvPointCompare(const cv::Point &a, const cv::Point &b) {
     return a.x < b.x;
 }
 
-std::vector<cv::Point> getMinBoxes(const std::vector<cv::Point> &inVec, float &minSideLen, float &allEdgeSize) {
+std::vector<cv::Point> getOrderedBox(const cv::RotatedRect &textRect) {
     std::vector<cv::Point> minBoxVec;
-    cv::RotatedRect textRect = cv::minAreaRect(inVec);
     cv::Mat boxPoints2f;
     cv::boxPoints(textRect, boxPoints2f);
 
@@ -239,10 +260,23 @@ std::vector<cv::Point> getMinBoxes(const std::vector<cv::Point> &inVec, float &m
     minBoxVec.push_back(tmpVec[index3]);
     minBoxVec.push_back(tmpVec[index4]);
 
+    return minBoxVec;
+}
+
+std::vector<cv::Point> getMinBoxes(const std::vector<cv::Point> &inVec, float &minSideLen, float &allEdgeSize) {
+    cv::RotatedRect textRect = cv::minAreaRect(inVec);
     minSideLen = (std::min)(textRect.size.width, textRect.size.height);
     allEdgeSize = 2.f * (textRect.size.width + textRect.size.height);
+    return getOrderedBox(textRect);
+}
 
-    return minBoxVec;
+cv::RotatedRect unClipRect(const cv::RotatedRect &rect, float unClipRatio) {
+    // 矩形按距离 d 做圆角外扩后，最小外接矩形即各边外移 d 的矩形
+    float width = rect.size.width, height = rect.size.height;
+    float perimeter = 2.f * (width + height);
+    if (perimeter <= 0.f) return rect;
+    float distance = unClipRatio * width * height / perimeter;
+    return cv::RotatedRect(rect.center, cv::Size2f(width + 2.f * distance, height + 2.f * distance), rect.angle);
 }
 
 float boxScoreFast(const cv::Mat &inMat, const std::vector<cv::Point> &inBox) {
@@ -284,10 +318,103 @@ float boxScoreFast(const cv::Mat &inMat, const std::vector<cv::Point> &inBox) {
 
     //std::cout << inMat << std::endl;
 
-    return cv::mean(inMat(cv::Rect(cv::Point(minX, minY), cv::Point(maxX + 1, maxY + 1))).clone(),
+    return cv::mean(inMat(cv::Rect(cv::Point(minX, minY), cv::Point(maxX + 1, maxY + 1))),
                     maskMat).val[0];
 }
 
+float boxScoreScanline(const cv::Mat &inMat, const std::vector<cv::Point> &inBox) {
+    // 活动边表逐行扫描多边形：边按起始行排序，逐行加入新边、移除已结束的边，每行只处理与之相交的边；
+    // 直接在概率图上按行求和，不分配掩码、不复制 ROI，每行的像素段用 SIMD 求和
+    struct Edge {
+        int y0, y1;   // 边覆盖的行范围 [y0, y1]
+        float x0;     // y0 处的 x
+        float slope;  // dx / dy
+    };
+    int n = (int) inBox.size();
+    if (n == 0 || inMat.empty()) return 0.f;
+
+    // 边表与行内缓冲区按线程复用，稳态下不再分配
+    static thread_local std::vector<Edge> edges;
+    static thread_local std::vector<cv::Vec3i> flats;  // 水平边 (y, x0, x1)
+    static thread_local std::vector<const Edge *> active;
+    static thread_local std::vector<float> crossings;
+    static thread_local std::vector<cv::Vec2i> spans;
+    edges.clear();
+    flats.clear();
+    active.clear();
+    int minY = INT_MAX, maxY = INT_MIN;
+    for (int i = 0; i < n; ++i) {
+        const cv::Point &a = inBox[i];
+        const cv::Point &b = inBox[(i + 1) % n];
+        minY = (std::min)(minY, a.y);
+        maxY = (std::max)(maxY, a.y);
+        if (a.y == b.y) {
+            flats.emplace_back(a.y, (std::min)(a.x, b.x), (std::max)(a.x, b.x));
+            continue;
+        }
+        const cv::Point &top = a.y < b.y ? a : b;
+        const cv::Point &bottom = a.y < b.y ? b : a;
+        edges.push_back(Edge{top.y, bottom.y, (float) top.x,
+                             (float) (bottom.x - top.x) / (float) (bottom.y - top.y)});
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge &l, const Edge &r) { return l.y0 < r.y0; });
+    std::sort(flats.begin(), flats.end(), [](const cv::Vec3i &l, const cv::Vec3i &r) { return l[0] < r[0]; });
+    minY = (std::max)(minY, 0);
+    maxY = (std::min)(maxY, inMat.rows - 1);
+
+    size_t nextEdge = 0, nextFlat = 0;
+    while (nextFlat < flats.size() && flats[nextFlat][0] < minY) ++nextFlat;
+    double sum = 0;
+    long long count = 0;
+    for (int y = minY; y <= maxY; ++y) {
+        // 加入从本行开始的边（首行还需补上跨过 minY 的边），移除已结束的边
+        for (; nextEdge < edges.size() && edges[nextEdge].y0 <= y; ++nextEdge)
+            if (edges[nextEdge].y1 >= y) active.push_back(&edges[nextEdge]);
+        active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge *e) { return e->y1 < y; }),
+                     active.end());
+
+        crossings.clear();
+        spans.clear();
+        // 水平边整段属于边界
+        for (; nextFlat < flats.size() && flats[nextFlat][0] == y; ++nextFlat)
+            spans.emplace_back(flats[nextFlat][1], flats[nextFlat][2]);
+        for (const Edge *e : active) {
+            // 边界：该边在本行 [y-0.5, y+0.5] 内经过的像素
+            float ya = (std::max)((float) e->y0, y - 0.5f), yb = (std::min)((float) e->y1, y + 0.5f);
+            float xa = e->x0 + (ya - e->y0) * e->slope, xb = e->x0 + (yb - e->y0) * e->slope;
+            spans.emplace_back(cvRound((std::min)(xa, xb)), cvRound((std::max)(xa, xb)));
+            // 内部：按半开区间 [y0, y1) 统计穿越点，顶点不重复计数
+            if (y < e->y1) crossings.push_back(e->x0 + (y - e->y0) * e->slope);
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+            spans.emplace_back((int) std::ceil(crossings[k]), (int) std::floor(crossings[k + 1]));
+
+        // 合并重叠的像素段后求和
+        std::sort(spans.begin(), spans.end(), [](const cv::Vec2i &l, const cv::Vec2i &r) { return l[0] < r[0]; });
+        const float *row = inMat.ptr<float>(y);
+        int end = -1;  // 已计入的最右像素
+        for (const cv::Vec2i &span : spans) {
+            int x0 = (std::max)((std::max)(span[0], end + 1), 0);
+            int x1 = (std::min)(span[1], inMat.cols - 1);
+            if (x0 > x1) continue;
+            sum += sumFloats(row + x0, x1 - x0 + 1);
+            count += x1 - x0 + 1;
+            end = x1;
+        }
+    }
+    return count > 0 ? (float) (sum / count) : 0.f;
+}
+
+float boxScoreRect(const cv::Mat &integral, const std::vector<cv::Point> &inBox) {
+    cv::Rect rect = cv::boundingRect(inBox) & cv::Rect(0, 0, integral.cols - 1, integral.rows - 1);
+    if (rect.empty()) return 0.f;
+    int x0 = rect.x, y0 = rect.y, x1 = rect.x + rect.width, y1 = rect.y + rect.height;
+    double sum = integral.at<double>(y1, x1) - integral.at<double>(y0, x1)
+                 - integral.at<double>(y1, x0) + integral.at<double>(y0, x0);
+    return (float) (sum / rect.area());
+}
+
 // use clipper
 std::vector<cv::Point> unClip(const std::vector<cv::Point> &inBox, float perimeter, float unClipRatio) {
     std::vector<cv::Point> outBox;
@@ -316,19 +443,106 @@ std::vector<cv::Point> unClip(const std::vector<cv::Point> &inBox, float perimet
     return outBox;
 }
 
-std::vector<float> substractMeanNormalize(cv::Mat &src, const float *meanVals, const float *normVals) {
-    auto inputTensorSize = src.cols * src.rows * src.channels();
-    std::vector<float> inputTensorValues(inputTensorSize);
-    size_t numChannels = src.channels();
-    size_t imageSize = src.cols * src.rows;
+std::vector<TextBox> mergeTileBoxes(const std::vector<TextBox> &boxes, const std::vector<int> &tileIds) {
+    int n = (int) boxes.size();
+    std::vector<std::vector<cv::Point2f>> quads(n);
+    std::vector<cv::Rect> rects(n);
+    std::vector<float> heights(n);
+    for (int i = 0; i < n; ++i) {
+        for (const cv::Point &p : boxes[i].boxPoint) quads[i].emplace_back((float) p.x, (float) p.y);
+        rects[i] = cv::boundingRect(boxes[i].boxPoint);
+        cv::Size2f size = cv::minAreaRect(quads[i]).size;
+        heights[i] = (std::min)(size.width, size.height);
+    }
+
+    // 并查集：只连接来自不同分块、且交集覆盖了大半个文字高度的框（重复检测或被接缝切开的同一行）；
+    // 相邻两行的框即使相交，交集也只是细长条，短边远小于文字高度，不会被合并
+    std::vector<int> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&parent](int i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&rects](int a, int b) { return rects[a].x < rects[b].x; });
+    std::vector<cv::Point2f> inter;
+    for (int oi = 0; oi < n; ++oi) {
+        int i = order[oi];
+        // 按左边界扫描，左边界越过 i 的右边界后不可能再相交
+        for (int oj = oi + 1; oj < n && rects[order[oj]].x < rects[i].br().x; ++oj) {
+            int j = order[oj];
+            if (tileIds[i] == tileIds[j] || (rects[i] & rects[j]).empty()) continue;
+            if (cv::intersectConvexConvex(quads[i], quads[j], inter) <= 0.f || inter.size() < 3) continue;
+            cv::Size2f interSize = cv::minAreaRect(inter).size;
+            float interSide = (std::min)(interSize.width, interSize.height);
+            if (interSide < 0.5f * (std::min)(heights[i], heights[j])) continue;
+            parent[findRoot(i)] = findRoot(j);
+        }
+    }
 
-    for (size_t pid = 0; pid < imageSize; pid++) {
-        for (size_t ch = 0; ch < numChannels; ++ch) {
-            float data = (float) (src.data[pid * numChannels + ch] * normVals[ch] - meanVals[ch] * normVals[ch]);
-            inputTensorValues[ch * imageSize + pid] = data;
+    // 每组取所有顶点的最小外接矩形，得分按面积加权
+    std::vector<std::vector<int>> groups(n);
+    for (int i = 0; i < n; ++i) groups[findRoot(i)].push_back(i);
+    std::vector<TextBox> merged;
+    for (int root = 0; root < n; ++root) {
+        const std::vector<int> &group = groups[root];
+        if (group.empty()) continue;
+        if (group.size() == 1) {
+            merged.push_back(boxes[group[0]]);
+            continue;
         }
+        std::vector<cv::Point> points;
+        double scoreSum = 0, areaSum = 0;
+        for (int i : group) {
+            points.insert(points.end(), boxes[i].boxPoint.begin(), boxes[i].boxPoint.end());
+            double area = (std::max)(1, rects[i].area());
+            scoreSum += boxes[i].score * area;
+            areaSum += area;
+        }
+        float minSideLen, perimeter;
+        merged.push_back(TextBox{getMinBoxes(points, minSideLen, perimeter), (float) (scoreSum / areaSum)});
+    }
+
+    // 按上边界、左边界排序，与整图检测的大致阅读顺序一致
+    std::vector<cv::Rect> mergedRects(merged.size());
+    for (size_t i = 0; i < merged.size(); ++i) mergedRects[i] = cv::boundingRect(merged[i].boxPoint);
+    std::vector<int> mergedOrder(merged.size());
+    std::iota(mergedOrder.begin(), mergedOrder.end(), 0);
+    std::stable_sort(mergedOrder.begin(), mergedOrder.end(), [&mergedRects](int a, int b) {
+        return mergedRects[a].y != mergedRects[b].y ? mergedRects[a].y < mergedRects[b].y
+                                                    : mergedRects[a].x < mergedRects[b].x;
+    });
+    std::vector<TextBox> sorted;
+    sorted.reserve(merged.size());
+    for (int i : mergedOrder) sorted.emplace_back(std::move(merged[i]));
+    return sorted;
+}
+
+void normalizeToTensor(const cv::Mat &src, float *dst, int dstWidth, int dstHeight,
+                       const float *meanVals, const float *normVals, bool swapRB) {
+    CV_Assert(src.depth() == CV_8U && src.cols <= dstWidth && src.rows <= dstHeight);
+    normalizeToPlanar(src.data, src.cols, src.rows, src.step[0], src.channels(),
+                      dst, dstWidth, (size_t) dstWidth * dstHeight, meanVals, normVals, swapRB);
+}
+
+void packToTensorBytes(const cv::Mat &src, unsigned char *dst, int dstWidth, bool swapRB) {
+    CV_Assert(src.depth() == CV_8U && src.cols <= dstWidth);
+    cv::Mat out(src.rows, src.cols, CV_8UC3, dst, (size_t) dstWidth * 3);
+    switch (src.channels()) {
+        case 1:
+            cv::cvtColor(src, out, cv::COLOR_GRAY2BGR);
+            break;
+        case 4:
+            cv::cvtColor(src, out, swapRB ? cv::COLOR_BGRA2BGR : cv::COLOR_RGBA2BGR);
+            break;
+        default:
+            if (swapRB) src.copyTo(out);
+            else cv::cvtColor(src, out, cv::COLOR_RGB2BGR);
+            break;
     }
-    return inputTensorValues;
+    // 尺寸类型一致时 OpenCV 不重新分配，结果直接写在调用方缓冲区中
+    CV_Assert(out.data == dst);
 }
 
 std::vector<int> getAngleIndexes(std::vector<Angle> &angles) {
@@ -68,17 +68,78 @@ cv::Mat matRotateClockWise180(cv::Mat src);
 
 cv::Mat matRotateClockWise90(cv::Mat src);
 
+/**
+ * @brief 文本框透视校正后的尺寸（未做竖排旋转），框与图像无交集或退化时返回空尺寸
+ * @param bounds 可选，输出框外接矩形与图像的交集
+ */
+cv::Size getRotateCropSize(const cv::Mat &src, const std::vector<cv::Point> &box, cv::Rect *bounds = NULL);
+
 cv::Mat getRotateCropImage(const cv::Mat &src, std::vector<cv::Point> box);
 
 cv::Mat adjustTargetImg(cv::Mat &src, int dstWidth, int dstHeight);
 
+/**
+ * @brief 旋转矩形的 4 个顶点（取整），按左上、右上、右下、左下排序
+ */
+std::vector<cv::Point> getOrderedBox(const cv::RotatedRect &textRect);
+
 std::vector<cv::Point> getMinBoxes(const std::vector<cv::Point> &inVec, float &minSideLen, float &allEdgeSize);
 
 float boxScoreFast(const cv::Mat &inMat, const std::vector<cv::Point> &inBox);
 
+/**
+ * @brief 多边形内概率均值（逐行扫描）：活动边表逐行求出多边形覆盖的像素段，直接在 float 概率图上求和，不分配掩码
+ * 内部像素与 fillPoly 一致，边界像素按边在每行内经过的范围取整，与 fillPoly 的线段光栅化可能相差一个像素，
+ * 得分与 boxScoreFast 略有差异，需显式启用
+ */
+float boxScoreScanline(const cv::Mat &inMat, const std::vector<cv::Point> &inBox);
+
+/**
+ * @brief 外接矩形内概率均值，由积分图 O(1) 求得
+ * @param integral 概率图的积分图（cv::integral，CV_64F，(rows+1) x (cols+1)），每帧只算一次，所有框共用
+ */
+float boxScoreRect(const cv::Mat &integral, const std::vector<cv::Point> &inBox);
+
 std::vector<cv::Point> unClip(const std::vector<cv::Point> &inBox, float perimeter, float unClipRatio);
 
-std::vector<float> substractMeanNormalize(cv::Mat &src, const float *meanVals, const float *normVals);
+/**
+ * @brief 矩形框的解析外扩，与 unClip（Clipper 圆角偏移）后再取最小外接矩形等价：
+ * 中心与角度不变，宽高各加 2d，d = unClipRatio * 面积 / 周长
+ */
+cv::RotatedRect unClipRect(const cv::RotatedRect &rect, float unClipRatio);
+
+/**
+ * @brief 合并分块检测的文本框（已换算到整图坐标）：重叠区内的重复框与被接缝切开的同一行合并为一个框
+ * @param tileIds 与 boxes 一一对应的分块编号，同一分块内的框不合并
+ * @return 合并后的框，按上边界、左边界排序
+ */
+std::vector<TextBox> mergeTileBoxes(const std::vector<TextBox> &boxes, const std::vector<int> &tileIds);
+
+/**
+ * @brief 8 位图像一次完成 BGR->RGB 交换、(pixel - mean) * norm 与 HWC->CHW 转置，直接写入张量缓冲区
+ * src 写入每个 dstWidth x dstHeight 平面的左上角，其余区域不写（由调用方预先填充）
+ * 支持 ROI（按行步长读取）与 1/3/4 通道输入，SIMD 实现见 OcrKernels
+ * @param dst    批内某一张的起始地址（3 个连续平面）
+ * @param swapRB true 表示 src 为 BGR 顺序，输出平面按 RGB 排列
+ */
+void normalizeToTensor(const cv::Mat &src, float *dst, int dstWidth, int dstHeight,
+                       const float *meanVals, const float *normVals, bool swapRB);
+
+/**
+ * @brief 原始字节输入模型：把 8 位 1/3/4 通道图按 BGR 三通道写入 NHWC 字节张量（归一化由模型图完成）
+ * src 写入行宽为 dstWidth 像素的图像左上角，其余区域不写（由调用方预先填充）
+ * @param dst    批内某一张的起始地址
+ * @param swapRB true 表示 src 为 BGR 顺序（直接复制），false 表示 RGB 顺序
+ */
+void packToTensorBytes(const cv::Mat &src, unsigned char *dst, int dstWidth, bool swapRB);
+
+/**
+ * @brief 归一化后为 0 的像素（即均值色，四舍五入）的 BGR 值，用作原始字节输入的填充色
+ * @param meanVals RGB 顺序的均值
+ */
+inline cv::Scalar meanPixelBgr(const float *meanVals) {
+    return cv::Scalar(cvRound(meanVals[2]), cvRound(meanVals[1]), cvRound(meanVals[0]));
+}
 
 std::vector<int> getAngleIndexes(std::vector<Angle> &angles);
 
@@ -0,0 +1,379 @@
+#include "OnnxNet.h"
+#include "OcrUtils.h"
+#include "OcrKernels.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+namespace {
+
+struct GlobalPoolConfig {
+    bool enabled = false;
+    int intraThreads = 0;
+    int interThreads = 1;
+    std::string affinity;
+    bool allowSpinning = true;
+};
+
+std::mutex g_envMutex;
+GlobalPoolConfig g_poolConfig;
+// 有意不释放：静态析构顺序不确定，Env 必须晚于所有会话（含调用方静态对象持有的会话）销毁
+Ort::Env *g_env = nullptr;
+// 进程内所有会话共享的预打包权重，同样有意不释放
+Ort::PrepackedWeightsContainer *g_prepackedWeights = nullptr;
+
+// 每个会话最多记录的输入形状数（rec 宽度已按 32 取整，正常远小于该值）
+const size_t kMaxKnownShapes = 256;
+
+// 会话的图优化级别，同时参与缓存键计算
+const GraphOptimizationLevel kOptLevel = GraphOptimizationLevel::ORT_ENABLE_EXTENDED;
+
+const uint64_t kFnvOffset = 14695981039346656037ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a(uint64_t h, const unsigned char *data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= data[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+bool hashFile(const std::string &pathStr, uint64_t &h) {
+#ifdef _WIN32
+    std::ifstream in(strToWstr(pathStr), std::ios::binary);
+#else
+    std::ifstream in(pathStr, std::ios::binary);
+#endif
+    if (!in) return false;
+    std::vector<char> buf(1 << 20);
+    while (in) {
+        in.read(buf.data(), (std::streamsize) buf.size());
+        h = fnv1a(h, reinterpret_cast<const unsigned char *>(buf.data()), (size_t) in.gcount());
+    }
+    return in.eof();
+}
+
+#ifdef _WIN32
+typedef std::wstring OrtPathString;
+OrtPathString toOrtPath(const std::string &pathStr) { return strToWstr(pathStr); }
+#else
+typedef std::string OrtPathString;
+OrtPathString toOrtPath(const std::string &pathStr) { return pathStr; }
+#endif
+
+bool isOrtFormat(const std::string &pathStr) {
+    std::string ext = std::filesystem::u8path(pathStr).extension().u8string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char) std::tolower(c); });
+    return ext == ".ort";
+}
+
+Ort::PrepackedWeightsContainer &prepackedWeights() {
+    std::lock_guard<std::mutex> lock(g_envMutex);
+    if (g_prepackedWeights == nullptr) g_prepackedWeights = new Ort::PrepackedWeightsContainer();
+    return *g_prepackedWeights;
+}
+
+void removeFile(const std::string &pathStr) {
+    std::error_code ec;
+    std::filesystem::remove(std::filesystem::u8path(pathStr), ec);
+}
+
+}
+
+bool OnnxNet::setGlobalThreadPool(int intraThreads, int interThreads, const std::string &affinity,
+                                  bool allowSpinning) {
+    std::lock_guard<std::mutex> lock(g_envMutex);
+    if (g_env != nullptr) return false;
+    g_poolConfig.enabled = true;
+    g_poolConfig.intraThreads = intraThreads < 0 ? 0 : intraThreads;
+    g_poolConfig.interThreads = interThreads < 1 ? 1 : interThreads;
+    g_poolConfig.affinity = affinity;
+    g_poolConfig.allowSpinning = allowSpinning;
+    return true;
+}
+
+Ort::Env &OnnxNet::sharedEnv() {
+    std::lock_guard<std::mutex> lock(g_envMutex);
+    if (g_env == nullptr) {
+        if (g_poolConfig.enabled) {
+            Ort::ThreadingOptions threadingOptions;
+            threadingOptions.SetGlobalIntraOpNumThreads(g_poolConfig.intraThreads);
+            threadingOptions.SetGlobalInterOpNumThreads(g_poolConfig.interThreads);
+            threadingOptions.SetGlobalSpinControl(g_poolConfig.allowSpinning);
+            if (!g_poolConfig.affinity.empty()) {
+                // C++ 封装未提供该接口，直接调用 C API（ORT >= 1.14）
+                Ort::ThrowOnError(Ort::GetApi().SetGlobalIntraOpThreadAffinity(
+                        threadingOptions, g_poolConfig.affinity.c_str()));
+            }
+            g_env = new Ort::Env(threadingOptions, ORT_LOGGING_LEVEL_ERROR, "OcrDetect");
+        } else {
+            g_env = new Ort::Env(ORT_LOGGING_LEVEL_ERROR, "OcrDetect");
+        }
+    }
+    return *g_env;
+}
+
+bool OnnxNet::usesGlobalThreadPool() {
+    std::lock_guard<std::mutex> lock(g_envMutex);
+    return g_poolConfig.enabled;
+}
+
+OnnxNet::OnnxNet() : memoryInfo(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU)) {}
+
+OnnxNet::~OnnxNet() {
+    releaseSession();
+}
+
+void OnnxNet::setNumThread(int numOfThread) {
+    if (numOfThread < 0) numOfThread = 0;
+    if (numOfThread == numThread) return;
+    numThread = numOfThread;
+    // 全局线程池下会话不使用该参数，重建没有意义
+    if (session != nullptr && !usesGlobalThreadPool()) sessionStale = true;
+}
+
+void OnnxNet::setThreadSpinning(bool allow) {
+    if (allow == allowSpinning) return;
+    allowSpinning = allow;
+    // 与线程数一起由 applySessionOptions 合并为一次重建；全局线程池的自旋在 sharedEnv 中设定
+    if (session != nullptr && !usesGlobalThreadPool()) sessionStale = true;
+}
+
+bool OnnxNet::applySessionOptions() {
+    if (session == nullptr || !sessionStale) return false;
+    loadSession(modelPath);
+    return true;
+}
+
+void OnnxNet::setModelCacheDir(const std::string &dir) {
+    modelCacheDir = dir;
+}
+
+void OnnxNet::setUseMmap(bool use) {
+    useMmap = use;
+}
+
+void OnnxNet::releaseSession() {
+    resetWorkspace();
+    delete session;
+    session = nullptr;
+    mappedModel.close();
+    free(inputName);
+    inputName = nullptr;
+    free(outputName);
+    outputName = nullptr;
+}
+
+void OnnxNet::resetWorkspace() {
+    // 绑定引用会话，先于会话释放；缓冲区保留，重建会话后继续复用
+    ioBinding.reset();
+    boundInput = Ort::Value(nullptr);
+    boundOutput = Ort::Value(nullptr);
+    boundInputShape = std::array<int64_t, 4>{};
+    boundInputData = nullptr;
+    boundOutputData = nullptr;
+    boundOutputShape.clear();
+    outputShapes.clear();
+}
+
+float *OnnxNet::inputBuffer(size_t count) {
+    if (inputData.size() < count) inputData.resize(count);
+    return inputData.data();
+}
+
+unsigned char *OnnxNet::inputBytes(size_t count) {
+    if (inputByteData.size() < count) inputByteData.resize(count);
+    return inputByteData.data();
+}
+
+Ort::Value OnnxNet::createInputTensor(void *input, size_t count, const std::array<int64_t, 4> &inputShape) {
+    if (rawInput)
+        return Ort::Value::CreateTensor<uint8_t>(memoryInfo, (uint8_t *) input, count,
+                                                 inputShape.data(), inputShape.size());
+    return Ort::Value::CreateTensor<float>(memoryInfo, (float *) input, count,
+                                           inputShape.data(), inputShape.size());
+}
+
+const float *OnnxNet::run(const std::array<int64_t, 4> &inputShape, std::vector<int64_t> &outputShape) {
+    size_t inputCount = 1;
+    for (int64_t d : inputShape) inputCount *= (size_t) d;
+    void *input = rawInput ? (void *) inputBytes(inputCount) : (void *) inputBuffer(inputCount);
+
+    auto known = outputShapes.find(inputShape);
+    if (known == outputShapes.end()) {
+        // 新形状：由 ORT 分配输出，记录输出形状后复制到工作区（每个形状只发生一次）
+        // 形状表有上限，超出时清空重新记录，避免输入形状过多时无限增长
+        if (outputShapes.size() >= kMaxKnownShapes) outputShapes.clear();
+        Ort::Value inputTensor = createInputTensor(input, inputCount, inputShape);
+        auto outputTensor = session->Run(Ort::RunOptions{nullptr}, &inputName, &inputTensor, 1, &outputName, 1);
+        outputShape = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape();
+        size_t outputCount = outputTensor[0].GetTensorTypeAndShapeInfo().GetElementCount();
+        if (outputData.size() < outputCount) outputData.resize(outputCount);
+        const float *result = outputTensor[0].GetTensorData<float>();
+        std::copy(result, result + outputCount, outputData.begin());
+        outputShapes.emplace(inputShape, outputShape);
+        return outputData.data();
+    }
+
+    outputShape = known->second;
+    size_t outputCount = 1;
+    for (int64_t d : outputShape) outputCount *= (size_t) d;
+    if (outputData.size() < outputCount) outputData.resize(outputCount);
+
+    if (!ioBinding) ioBinding.reset(new Ort::IoBinding(*session));
+    // 形状与缓冲区地址都未变化时沿用已有绑定
+    if (inputShape != boundInputShape || input != boundInputData) {
+        boundInput = createInputTensor(input, inputCount, inputShape);
+        ioBinding->BindInput(inputName, boundInput);
+        boundInputShape = inputShape;
+        boundInputData = input;
+    }
+    if (outputShape != boundOutputShape || outputData.data() != boundOutputData) {
+        boundOutput = Ort::Value::CreateTensor<float>(memoryInfo, outputData.data(), outputCount,
+                                                      outputShape.data(), outputShape.size());
+        ioBinding->BindOutput(outputName, boundOutput);
+        boundOutputShape = outputShape;
+        boundOutputData = outputData.data();
+    }
+    session->Run(Ort::RunOptions{nullptr}, *ioBinding);
+    return outputData.data();
+}
+
+Ort::SessionOptions OnnxNet::buildSessionOptions() const {
+    Ort::SessionOptions sessionOptions;
+    //===session options===
+    if (usesGlobalThreadPool()) {
+        // 使用 sharedEnv() 中的全局线程池，会话不再创建私有线程池
+        sessionOptions.DisablePerSessionThreads();
+    } else {
+        // Sets the number of threads used to parallelize the execution within nodes
+        // A value of 0 means ORT will pick a default
+        sessionOptions.SetIntraOpNumThreads(numThread);
+
+        // Sets the number of threads used to parallelize the execution of the graph (across nodes)
+        // 默认顺序执行（ORT_SEQUENTIAL），节点间并行线程不会被使用，固定为 1 避免多建空闲线程
+        sessionOptions.SetInterOpNumThreads(1);
+
+        // 线程池空闲自旋：默认开启，关闭后空闲时让出 CPU
+        const char *spin = allowSpinning ? "1" : "0";
+        sessionOptions.AddConfigEntry("session.intra_op.allow_spinning", spin);
+        sessionOptions.AddConfigEntry("session.inter_op.allow_spinning", spin);
+    }
+
+    // Sets graph optimization level
+    // ORT_DISABLE_ALL -> To disable all optimizations
+    // ORT_ENABLE_BASIC -> To enable basic optimizations (Such as redundant node removals)
+    // ORT_ENABLE_EXTENDED -> To enable extended optimizations (Includes level 1 + more complex optimizations like node fusions)
+    // ORT_ENABLE_ALL -> To Enable All possible opitmizations
+    sessionOptions.SetGraphOptimizationLevel(kOptLevel);
+    return sessionOptions;
+}
+
+std::string OnnxNet::cachedModelPath(const std::string &pathStr) const {
+    uint64_t h = kFnvOffset;
+    if (!hashFile(pathStr, h)) return "";
+    // 优化结果依赖 ORT 版本、优化级别与 CPU 指令集，一并计入缓存键
+    std::string runtimeKey = std::string(OrtGetApiBase()->GetVersionString()) + "|" + std::to_string((int) kOptLevel)
+                             + "|" + kernelIsaName();
+    h = fnv1a(h, reinterpret_cast<const unsigned char *>(runtimeKey.data()), runtimeKey.size());
+
+    std::filesystem::path modelFile = std::filesystem::u8path(pathStr);
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) h);
+    std::string dir = modelCacheDir;
+    if (dir.back() != '/' && dir.back() != '\\') dir += '/';
+    return dir + modelFile.stem().u8string() + "." + hex + ".ort";
+}
+
+Ort::Session *OnnxNet::createSession(const std::string &pathStr, Ort::SessionOptions &sessionOptions,
+                                     MappedFile &mapping) {
+    bool ortFormat = isOrtFormat(pathStr);
+    if (ortFormat) sessionOptions.AddConfigEntry("session.load_model_format", "ORT");
+    if (useMmap && mapping.open(pathStr)) {
+        if (ortFormat) {
+            // 会话直接引用映射字节（含初始化器），不再复制到堆上
+            sessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            sessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+        }
+        try {
+            return new Ort::Session(sharedEnv(), mapping.data(), mapping.size(), sessionOptions,
+                                    prepackedWeights());
+        } catch (...) {
+            mapping.close();
+            throw;
+        }
+    }
+    OrtPathString path = toOrtPath(pathStr);
+    return new Ort::Session(sharedEnv(), path.c_str(), sessionOptions, prepackedWeights());
+}
+
+void OnnxNet::loadSession(const std::string &pathStr) {
+    releaseSession();
+    sessionStale = false;
+    modelPath = pathStr;
+    loadedFromCache = false;
+
+    std::string cachePath = modelCacheDir.empty() ? std::string() : cachedModelPath(pathStr);
+    if (!cachePath.empty() && isFileExists(cachePath)) {
+        try {
+            Ort::SessionOptions sessionOptions = buildSessionOptions();
+            session = createSession(cachePath, sessionOptions, mappedModel);
+            loadedFromCache = true;
+        } catch (const Ort::Exception &) {
+            // 缓存损坏或与当前运行时不兼容：删除后从原始模型重建
+            removeFile(cachePath);
+        }
+    }
+    if (session == nullptr && !cachePath.empty()) {
+        // 先写临时文件再改名，多个进程同时启动时不会读到写了一半的缓存
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::u8path(modelCacheDir), ec);
+        std::string tmpPath = cachePath + "." + std::to_string(std::random_device{}()) + ".tmp";
+        OrtPathString ortTmpPath = toOrtPath(tmpPath);
+        try {
+            Ort::SessionOptions sessionOptions = buildSessionOptions();
+            sessionOptions.AddConfigEntry("session.save_model_format", "ORT");
+            sessionOptions.SetOptimizedModelFilePath(ortTmpPath.c_str());
+            session = createSession(pathStr, sessionOptions, mappedModel);
+            std::filesystem::rename(std::filesystem::u8path(tmpPath), std::filesystem::u8path(cachePath), ec);
+        } catch (const Ort::Exception &) {
+            // 缓存目录不可写等：放弃缓存，下面按原始模型加载
+        }
+        removeFile(tmpPath);
+        if (session != nullptr && useMmap && !ec && isFileExists(cachePath)) {
+            // 由 ONNX 创建的会话持有堆上权重；改为从刚写入的缓存映射加载，与后续启动的进程共享物理页
+            // 旧会话可能引用 mappedModel（源模型为 .ort 时），新映射先放在局部对象中，旧会话释放后再替换
+            MappedFile cacheMapping;
+            try {
+                Ort::SessionOptions sessionOptions = buildSessionOptions();
+                Ort::Session *mapped = createSession(cachePath, sessionOptions, cacheMapping);
+                delete session;
+                session = mapped;
+                mappedModel.swap(cacheMapping);
+                loadedFromCache = true;
+            } catch (const Ort::Exception &) {
+                // 继续使用旧会话及其映射
+            }
+        }
+    }
+    if (session == nullptr) {
+        Ort::SessionOptions sessionOptions = buildSessionOptions();
+        session = createSession(pathStr, sessionOptions, mappedModel);
+    }
+
+    getInputName(session, inputName);
+    getOutputName(session, outputName);
+
+    Ort::TypeInfo inputInfo = session->GetInputTypeInfo(0);
+    auto tensorInfo = inputInfo.GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> inputShape = tensorInfo.GetShape();
+    modelBatch = (!inputShape.empty() && inputShape[0] > 0) ? (int) inputShape[0] : 0;
+    // batch 维在 NCHW 与 NHWC 中都是第 0 维
+    rawInput = tensorInfo.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+}
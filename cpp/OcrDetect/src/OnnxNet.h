@@ -0,0 +1,186 @@
+#ifndef __OCR_ONNXNET_H__
+#define __OCR_ONNXNET_H__
+
+#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+/**
+ * DbNet / AngleNet / CrnnNet 共用的 ONNX Runtime 会话管理
+ *
+ * 线程等会话参数只在创建会话前生效，因此 setter 只记录参数，参数变化时把会话标记为待重建；
+ * 多个 setter 的变化由 applySessionOptions 合并为一次重建，参数未变化时为空操作（可在每次请求前调用）
+ *
+ * 进程内所有 OcrLite 实例共享同一个 Ort::Env；启用全局线程池后所有会话共用
+ * 一组 intra/inter-op 线程（DisablePerSessionThreads），多引擎同进程时不再超额订阅 CPU
+ *
+ * 所有会话共用进程级 PrepackedWeightsContainer，同进程多个引擎加载同一模型时预打包权重只保留一份；
+ * 启用 mmap 后 ORT 格式模型（.ort 或优化缓存）直接引用映射页中的权重，多进程共享物理内存
+ *
+ * 每个模型持有一个推理工作区：输入/输出缓冲区只增不减，通过 IoBinding 绑定，
+ * ORT 直接把输出写入预分配缓冲区，后处理原地读取；形状不变时连绑定都不重建
+ * 只有已执行过的输入形状走绑定路径，因此子类把输入尺寸限制在少数几种（det 分桶、rec 宽度按 32 取整）
+ *
+ * 模型输入为 uint8 时（python/prepare_uint8_models.py 生成，图内完成 Cast/Transpose/减均值/乘系数）
+ * 按原始字节输入处理：子类把 BGR 像素按 NHWC 写入字节工作区，不再在 CPU 上归一化成 float
+ */
+class OnnxNet {
+public:
+    /**
+     * @brief 启用进程级全局线程池，必须在第一个会话创建前调用
+     * @param intraThreads 全局算子内线程数，0 表示由 ORT 决定
+     * @param interThreads 全局节点间线程数
+     * @param affinity     intra-op 线程亲和性（ORT 格式，如 "1,2;3,4"，每组对应一个线程，
+     *                     线程数为 intraThreads - 1），空字符串表示不绑定
+     * @param allowSpinning 线程池空闲时是否自旋
+     * @return 共享环境已创建（太晚调用）时返回 false
+     */
+    static bool setGlobalThreadPool(int intraThreads, int interThreads, const std::string &affinity,
+                                    bool allowSpinning);
+
+    /**
+     * @brief 进程内共享的 Ort::Env，首次调用时按全局线程池配置创建
+     */
+    static Ort::Env &sharedEnv();
+
+    OnnxNet();
+
+    virtual ~OnnxNet();
+
+    OnnxNet(const OnnxNet &) = delete;
+
+    OnnxNet &operator=(const OnnxNet &) = delete;
+
+    /**
+     * @brief 设置算子内（intra-op）线程数，0 表示由 ORT 决定（物理核数）
+     * 启用全局线程池时会话不再持有私有线程，此设置不生效，也不会触发重建
+     */
+    void setNumThread(int numOfThread);
+
+    /**
+     * @brief 设置线程池空闲时是否自旋等待；关闭可降低空闲 CPU 占用，代价是少量延迟
+     * 重建规则同 setNumThread；启用全局线程池时由 setGlobalThreadPool 的 allowSpinning 决定
+     */
+    void setThreadSpinning(bool allow);
+
+    /**
+     * @brief 设置优化后模型的缓存目录，空字符串表示不缓存（默认），须在 initModel 前调用
+     * 首次加载时把图优化结果以 ORT 格式写入该目录，之后直接加载缓存、跳过图优化；
+     * 缓存文件名包含模型内容哈希、ORT 版本与优化级别，模型或运行时变化后自动失效
+     */
+    void setModelCacheDir(const std::string &dir);
+
+    /**
+     * @brief 从只读内存映射创建会话，须在 initModel 前调用
+     * ORT 格式模型的初始化器直接引用映射字节，同机多个进程共享同一份物理页；
+     * ONNX 格式模型仍会被 ORT 解析复制到堆上，需配合 setModelCacheDir 或直接使用 .ort 模型
+     */
+    void setUseMmap(bool use);
+
+    /**
+     * @brief 应用挂起的会话参数：setter 记录的变化在这里合并为一次会话重建
+     * @return 是否重建了会话（重建后已执行过的输入形状清空）
+     */
+    bool applySessionOptions();
+
+    /** @brief 当前会话是否由优化模型缓存创建 */
+    bool isLoadedFromCache() const { return loadedFromCache; }
+
+    /** @brief 当前模型是否为原始字节输入（uint8 NHWC，BGR） */
+    bool isRawInput() const { return rawInput; }
+
+protected:
+    Ort::Session *session = nullptr;
+    char *inputName = nullptr;
+    char *outputName = nullptr;
+    int modelBatch = 0;  // 模型输入的固定 batch 维，0 表示动态
+    bool rawInput = false;  // 模型输入为 uint8 NHWC（BGR），由会话输入类型检测
+
+    /**
+     * @brief 工作区输入缓冲区，至少 count 个 float（只增不减，保留上次内容，需要时由调用方清零）
+     * 返回的指针在下一次 inputBuffer 扩容前有效
+     */
+    float *inputBuffer(size_t count);
+
+    /** @brief 原始字节输入模型的工作区输入缓冲区，至少 count 字节，约定同 inputBuffer */
+    unsigned char *inputBytes(size_t count);
+
+    /** @brief batch 张 height × width 三通道图像的输入形状：原始字节输入为 NHWC，否则为 NCHW */
+    std::array<int64_t, 4> imageShape(int batch, int height, int width) const {
+        if (rawInput) return {batch, height, width, 3};
+        return {batch, 3, height, width};
+    }
+
+    /**
+     * @brief 以工作区输入缓冲区（按 inputShape 解释）执行推理，返回原地可读的输出
+     * 原始字节输入模型使用 inputBytes 缓冲区，inputShape 为 NHWC
+     * 某个输入形状首次出现时由 ORT 分配输出以获知输出形状，此后该形状直接绑定预分配输出缓冲区，
+     * 稳态推理不再分配输入/输出内存
+     * @param outputShape 输出形状
+     * @return 输出数据，下一次 run 前有效
+     */
+    const float *run(const std::array<int64_t, 4> &inputShape, std::vector<int64_t> &outputShape);
+
+    /** @brief 当前会话是否已执行过该输入形状（会话重建后清空） */
+    bool isShapeKnown(const std::array<int64_t, 4> &inputShape) const {
+        return outputShapes.count(inputShape) != 0;
+    }
+
+    /**
+     * @brief 按当前线程参数创建会话并读取输入输出名；重复调用会先释放旧会话
+     * 设置了缓存目录时优先加载缓存，缓存缺失或损坏时从原始模型创建并写入缓存
+     */
+    void loadSession(const std::string &pathStr);
+
+private:
+    std::string modelPath;
+    int numThread = 0;
+    bool allowSpinning = true;
+    bool sessionStale = false;  // 会话参数已变化，待 applySessionOptions 重建
+    std::string modelCacheDir;
+    bool loadedFromCache = false;
+    bool useMmap = false;
+    MappedFile mappedModel;  // 会话引用映射字节，须晚于会话释放
+
+    // ===== 推理工作区 =====
+    Ort::MemoryInfo memoryInfo;
+    std::vector<float> inputData;
+    std::vector<unsigned char> inputByteData;
+    std::vector<float> outputData;
+    std::map<std::array<int64_t, 4>, std::vector<int64_t>> outputShapes;  // 输入形状 -> 已知输出形状
+    std::unique_ptr<Ort::IoBinding> ioBinding;  // 须早于会话释放
+    Ort::Value boundInput{nullptr};
+    Ort::Value boundOutput{nullptr};
+    std::array<int64_t, 4> boundInputShape{};
+    const void *boundInputData = nullptr;
+    const float *boundOutputData = nullptr;
+    std::vector<int64_t> boundOutputShape;
+
+    void resetWorkspace();
+
+    /** @brief 按 rawInput 以 uint8 或 float 包装工作区输入 */
+    Ort::Value createInputTensor(void *input, size_t count, const std::array<int64_t, 4> &inputShape);
+
+    static bool usesGlobalThreadPool();
+
+    void releaseSession();
+
+    Ort::SessionOptions buildSessionOptions() const;
+
+    /** @brief 缓存文件路径 <cacheDir>/<模型名>.<哈希>.ort，模型不可读时返回空 */
+    std::string cachedModelPath(const std::string &pathStr) const;
+
+    /**
+     * @brief 创建会话（.ort 后缀按 ORT 格式加载）；启用 mmap 时从映射字节创建，映射保存在 mapping
+     * 会话可能直接引用映射字节，mapping 须在会话释放后才能关闭；创建失败时 mapping 为空
+     */
+    Ort::Session *createSession(const std::string &pathStr, Ort::SessionOptions &sessionOptions,
+                                MappedFile &mapping);
+};
+
+
+#endif //__OCR_ONNXNET_H__
@@ -4,6 +4,8 @@
 #include "../include/ocrdetect/ocr_api.h"
 #include "../include/ocrdetect/export.h"
 #include "OcrLite.h"
+#include "OcrPipeline.h"
+#include "OcrStream.h"
 #include "OcrUtils.h"
 #include <opencv2/opencv.hpp>
 #include <cstring>
@@ -22,14 +24,168 @@ static std::string join_path(const char* dir, const char* name) {
   return s;
 }
 
+/** 模型文件路径：INT8 精度时优先 <name>.int8.onnx，不存在时回退 <name>.onnx */
+static std::string model_path(const char* dir, const char* name, bool int8) {
+  if (int8) {
+    std::string quantized = join_path(dir, (std::string(name) + ".int8.onnx").c_str());
+    if (isFileExists(quantized)) return quantized;
+  }
+  return join_path(dir, (std::string(name) + ".onnx").c_str());
+}
+
+struct DetectParams {
+  int padding = 0;
+  int short_side_len = 960;
+  float box_score_thresh = 0.6f;
+  float box_thresh = 0.3f;
+  float un_clip_ratio = 2.0f;
+  bool do_angle = true;
+  bool most_angle = true;
+};
+
+/** options 为 NULL 时保留默认值 */
+static void read_options(const OCR_Options* options, DetectParams& p) {
+  if (!options) return;
+  p.padding = options->padding;
+  p.short_side_len = options->short_side_len;
+  p.box_score_thresh = options->box_score_thresh;
+  p.box_thresh = options->box_thresh;
+  p.un_clip_ratio = options->un_clip_ratio;
+  p.do_angle = (options->do_angle != 0);
+  p.most_angle = (options->most_angle != 0);
+}
+
+static float mean_confidence(const TextBlock& b) {
+  if (b.charScores.empty()) return 0.f;
+  float sum = 0;
+  for (float s : b.charScores) sum += s;
+  return sum / static_cast<float>(b.charScores.size());
+}
+
+/** 填充单个结果块，text 由 malloc 分配 */
+static void fill_block(const TextBlock& b, OCR_TextBlock* out) {
+  size_t pts = b.boxPoint.size();
+  if (pts > 4) pts = 4;
+  for (size_t k = 0; k < pts; k++) {
+    out->box[k].x = b.boxPoint[k].x;
+    out->box[k].y = b.boxPoint[k].y;
+  }
+  for (size_t k = pts; k < 4; k++) { out->box[k].x = 0; out->box[k].y = 0; }
+  out->box_score = b.boxScore;
+  out->text = nullptr;
+  if (!b.text.empty()) {
+    out->text = static_cast<char*>(malloc(b.text.size() + 1));
+    if (out->text) {
+      std::strcpy(out->text, b.text.c_str());
+    }
+  }
+  out->confidence = mean_confidence(b);
+}
+
+static void fill_blocks_cpp(const OcrResult& res, std::vector<OCR_TextBlockCpp>& out) {
+  out.clear();
+  out.reserve(res.textBlocks.size());
+  for (size_t i = 0; i < res.textBlocks.size(); ++i) {
+    const TextBlock& b = res.textBlocks[i];
+    OCR_TextBlockCpp tb;
+    size_t pts = b.boxPoint.size();
+    if (pts > 4) pts = 4;
+    for (size_t k = 0; k < pts; k++) {
+      tb.box[k][0] = static_cast<float>(b.boxPoint[k].x);
+      tb.box[k][1] = static_cast<float>(b.boxPoint[k].y);
+    }
+    for (size_t k = pts; k < 4; k++) { tb.box[k][0] = 0; tb.box[k][1] = 0; }
+    tb.box_score = b.boxScore;
+    tb.text = b.text;
+    tb.confidence = mean_confidence(b);
+    out.push_back(std::move(tb));
+  }
+}
+
+/**
+ * 像素格式 -> 通道数
+ * @param rgb_order 输出：3/4 通道是否为 RGB(A) 顺序
+ * @return 无效格式返回 0
+ */
+static int format_channels(int pixel_format, bool& rgb_order) {
+  rgb_order = false;
+  switch (pixel_format) {
+    case OCR_PIXEL_BGR: return 3;
+    case OCR_PIXEL_RGB: rgb_order = true; return 3;
+    case OCR_PIXEL_BGRA: return 4;
+    case OCR_PIXEL_RGBA: rgb_order = true; return 4;
+    case OCR_PIXEL_GRAY: return 1;
+    default: return 0;
+  }
+}
+
+/**
+ * 把调用方像素包装为 cv::Mat 头（不复制）
+ * @param rgb_order 输出：3/4 通道是否为 RGB(A) 顺序
+ * @return 像素格式或步长无效时返回空 Mat
+ */
+static cv::Mat wrap_image(const unsigned char* data, int width, int height, int stride,
+                          int pixel_format, bool& rgb_order) {
+  int channels = format_channels(pixel_format, rgb_order);
+  if (!data || width <= 0 || height <= 0 || channels == 0) return cv::Mat();
+  size_t row_bytes = static_cast<size_t>(width) * channels;
+  if (stride == 0) stride = static_cast<int>(row_bytes);
+  if (stride < 0 || static_cast<size_t>(stride) < row_bytes) return cv::Mat();
+  return cv::Mat(height, width, CV_8UC(channels), const_cast<unsigned char*>(data), static_cast<size_t>(stride));
+}
+
+/** 旧接口的通道数 -> 像素格式（BGR 顺序） */
+static int channels_to_format(int channels) {
+  switch (channels) {
+    case 1: return OCR_PIXEL_GRAY;
+    case 3: return OCR_PIXEL_BGR;
+    case 4: return OCR_PIXEL_BGRA;
+    default: return -1;
+  }
+}
+
+/** 由库分配 blocks 数组，需 ocr_free_result 释放 */
+static void fill_result(const OcrResult& res, OCR_Result* out) {
+  int n = static_cast<int>(res.textBlocks.size());
+  out->count = 0;
+  out->blocks = nullptr;
+  out->detect_time_ms = res.detectTime;
+  if (n == 0) return;
+  out->blocks = static_cast<OCR_TextBlock*>(malloc(sizeof(OCR_TextBlock) * n));
+  if (!out->blocks) return;
+  for (int i = 0; i < n; i++)
+    fill_block(res.textBlocks[i], out->blocks + i);
+  out->count = n;
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_set_global_thread_pool(
+  int intra_threads, int inter_threads, const char* affinity, int allow_spinning) {
+  return OnnxNet::setGlobalThreadPool(intra_threads, inter_threads, affinity ? affinity : "",
+                                      allow_spinning != 0) ? 0 : -1;
+}
+
 OCRDETECT_OCR_API OCR_Handle OCRDETECT_OCR_CALL ocr_create(const char* models_dir) {
+  return ocr_create_ex(models_dir, nullptr);
+}
+
+OCRDETECT_OCR_API OCR_Handle OCRDETECT_OCR_CALL ocr_create_ex(const char* models_dir,
+  const OCR_CreateOptions* options) {
   if (!models_dir || !models_dir[0]) return nullptr;
   try {
     OcrLite* p = new OcrLite();
     p->initLogger(false, false, false);
-    std::string det_path = join_path(models_dir, "det.onnx");
-    std::string cls_path = join_path(models_dir, "cls.onnx");
-    std::string rec_path = join_path(models_dir, "rec.onnx");
+    if (options) {
+      // 会话创建前设置，initModels 只创建一次会话
+      p->setModelThreads(options->det_num_threads, options->cls_num_threads, options->rec_num_threads);
+      p->setThreadSpinning(options->disable_spinning == 0);
+      if (options->model_cache_dir) p->setModelCacheDir(options->model_cache_dir);
+      p->setUseMmap(options->use_mmap != 0);
+    }
+    // 量化工具只保留通过精度校验的变体，因此各模型独立选择，缺少变体的模型仍用 FP32
+    bool int8 = options && options->precision == OCR_PRECISION_INT8;
+    std::string det_path = model_path(models_dir, "det", int8);
+    std::string cls_path = model_path(models_dir, "cls", int8);
+    std::string rec_path = model_path(models_dir, "rec", int8);
     std::string keys_path = join_path(models_dir, "ppocr_keys_v1.txt");
     if (!isFileExists(keys_path))
       keys_path = join_path(models_dir, "keys.txt");
@@ -51,6 +207,57 @@ OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_num_threads(OCR_Handle h, int
   if (h) static_cast<OcrLite*>(h)->setNumThread(n);
 }
 
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_model_threads(OCR_Handle h, int det, int cls, int rec) {
+  if (h) static_cast<OcrLite*>(h)->setModelThreads(det, cls, rec);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_thread_spinning(OCR_Handle h, int allow) {
+  if (h) static_cast<OcrLite*>(h)->setThreadSpinning(allow != 0);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_cls_batch_num(OCR_Handle h, int n) {
+  if (h) static_cast<OcrLite*>(h)->setClsBatchNum(n);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_rec_batch_num(OCR_Handle h, int n) {
+  if (h) static_cast<OcrLite*>(h)->setRecBatchNum(n);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_fused_crop(OCR_Handle h, int enable) {
+  if (h) static_cast<OcrLite*>(h)->setFusedCrop(enable != 0);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_det_tiling(OCR_Handle h, int tile_size, int overlap) {
+  if (h) static_cast<OcrLite*>(h)->setDetTiling(tile_size, overlap);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_fast_db_postprocess(OCR_Handle h, int enable) {
+  if (h) static_cast<OcrLite*>(h)->setFastDbPostprocess(enable != 0);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_db_rect_score(OCR_Handle h, int enable) {
+  if (h) static_cast<OcrLite*>(h)->setDbRectScore(enable != 0);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_db_scanline_score(OCR_Handle h, int enable) {
+  if (h) static_cast<OcrLite*>(h)->setDbScanlineScore(enable != 0);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_det_shape_buckets(OCR_Handle h, const int* sizes, int count) {
+  if (!h) return;
+  std::vector<int> buckets;
+  if (sizes && count > 0) buckets.assign(sizes, sizes + count);
+  static_cast<OcrLite*>(h)->setDetShapeBuckets(buckets);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_rec_line_split(OCR_Handle h, int window_width, int overlap) {
+  if (h) static_cast<OcrLite*>(h)->setRecLineSplit(window_width, overlap);
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_cls_sampling(OCR_Handle h, int max_samples) {
+  if (h) static_cast<OcrLite*>(h)->setClsSampling(max_samples);
+}
+
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_set_preprocess_save_path(OCR_Handle h, const char* path) {
   if (h) static_cast<OcrLite*>(h)->setPreprocessSavePath(path ? path : "");
 }
@@ -64,67 +271,221 @@ OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect(
   const unsigned char* image_data, int width, int height, int channels,
   const OCR_Options* options,
   OCR_TextBlock* results, int max_results) {
-  if (!h || !image_data || !results || max_results <= 0) return -1;
-  cv::Mat mat;
-  if (channels == 1)
-    mat = cv::Mat(height, width, CV_8UC1);
-  else if (channels == 3)
-    mat = cv::Mat(height, width, CV_8UC3);
-  else
-    return -2;
-  size_t copy_len = static_cast<size_t>(width * height * channels);
-  std::memcpy(mat.data, image_data, copy_len);
+  return ocr_detect_ex(h, image_data, width, height, 0, channels_to_format(channels),
+                       options, results, max_results);
+}
 
-  int padding = 0, short_side_len = 960;
-  float box_score_thresh = 0.6f, box_thresh = 0.3f, un_clip_ratio = 2.0f;
-  bool do_angle = true, most_angle = true;
-  if (options) {
-    padding = options->padding;
-    short_side_len = options->short_side_len;
-    box_score_thresh = options->box_score_thresh;
-    box_thresh = options->box_thresh;
-    un_clip_ratio = options->un_clip_ratio;
-    do_angle = (options->do_angle != 0);
-    most_angle = (options->most_angle != 0);
-  }
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_ex(
+  OCR_Handle h,
+  const unsigned char* image_data, int width, int height, int stride, int pixel_format,
+  const OCR_Options* options,
+  OCR_TextBlock* results, int max_results) {
+  if (!h || !image_data || !results || max_results <= 0) return -1;
+  bool rgb_order;
+  cv::Mat mat = wrap_image(image_data, width, height, stride, pixel_format, rgb_order);
+  if (mat.empty()) return -2;
 
-  OcrResult res = static_cast<OcrLite*>(h)->detect(mat, padding, short_side_len,
-    box_score_thresh, box_thresh, un_clip_ratio, do_angle, most_angle);
+  DetectParams p;
+  read_options(options, p);
+  OcrResult res = static_cast<OcrLite*>(h)->detect(mat, p.padding, p.short_side_len,
+    p.box_score_thresh, p.box_thresh, p.un_clip_ratio, p.do_angle, p.most_angle, rgb_order);
 
   int n = static_cast<int>(res.textBlocks.size());
   if (n > max_results) n = max_results;
-  for (int i = 0; i < n; i++) {
-    const TextBlock& b = res.textBlocks[i];
-    OCR_TextBlock* out = results + i;
-    size_t pts = b.boxPoint.size();
-    if (pts > 4) pts = 4;
-    for (size_t k = 0; k < pts; k++) {
-      out->box[k].x = b.boxPoint[k].x;
-      out->box[k].y = b.boxPoint[k].y;
+  for (int i = 0; i < n; i++)
+    fill_block(res.textBlocks[i], results + i);
+  return n;
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_batch(
+  OCR_Handle h,
+  const OCR_Image* images, int count,
+  const OCR_Options* options,
+  OCR_Result* results) {
+  if (!h || !images || !results || count < 0) return -1;
+  for (int i = 0; i < count; i++) {
+    results[i].count = -1;
+    results[i].blocks = nullptr;
+    results[i].detect_time_ms = 0;
+  }
+  try {
+    // 直接包装调用方像素（只读），无效图像以空 Mat 占位，保持下标对应
+    std::vector<cv::Mat> mats(count);
+    std::vector<bool> rgb_order(count, false);
+    for (int i = 0; i < count; i++) {
+      const OCR_Image& img = images[i];
+      bool rgb;
+      mats[i] = wrap_image(img.data, img.width, img.height, img.stride, img.pixel_format, rgb);
+      rgb_order[i] = rgb;
     }
-    for (size_t k = pts; k < 4; k++) { out->box[k].x = 0; out->box[k].y = 0; }
-    out->box_score = b.boxScore;
-    out->text = nullptr;
-    if (!b.text.empty()) {
-      out->text = static_cast<char*>(malloc(b.text.size() + 1));
-      if (out->text) {
-        std::strcpy(out->text, b.text.c_str());
-      }
+    DetectParams p;
+    read_options(options, p);
+    std::vector<OcrResult> res = static_cast<OcrLite*>(h)->detectBatch(mats, p.padding, p.short_side_len,
+      p.box_score_thresh, p.box_thresh, p.un_clip_ratio, p.do_angle, p.most_angle, &rgb_order);
+    for (int i = 0; i < count; i++) {
+      fill_result(res[i], results + i);
+      if (mats[i].empty()) results[i].count = -1;
     }
-    if (b.charScores.empty()) out->confidence = 0.f;
-    else {
-      float sum = 0;
-      for (float s : b.charScores) sum += s;
-      out->confidence = sum / static_cast<float>(b.charScores.size());
+    return 0;
+  } catch (...) {
+    // 异常不跨越 C 接口；已填充的结果释放后统一置为无效，调用方仍可对每个元素调用 ocr_free_result
+    for (int i = 0; i < count; i++) {
+      if (results[i].count > 0) ocr_free_result(results + i);
+      results[i].count = -1;
+      results[i].blocks = nullptr;
     }
+    return -2;
   }
-  return n;
 }
 
 OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_free_text(char* text) {
   if (text) free(text);
 }
 
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_free_result(OCR_Result* result) {
+  if (!result) return;
+  if (result->blocks) {
+    for (int i = 0; i < result->count; i++)
+      free(result->blocks[i].text);
+    free(result->blocks);
+  }
+  result->blocks = nullptr;
+  result->count = 0;
+}
+
+OCRDETECT_OCR_API OCR_Pipeline OCRDETECT_OCR_CALL ocr_pipeline_create(OCR_Handle h, int queue_depth) {
+  if (!h) return nullptr;
+  try {
+    return static_cast<void*>(new OcrPipeline(*static_cast<OcrLite*>(h), queue_depth > 0 ? queue_depth : 4));
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_pipeline_destroy(OCR_Pipeline p) {
+  if (p) delete static_cast<OcrPipeline*>(p);
+}
+
+static long long pipeline_submit(OCR_Pipeline p, const cv::Mat& image, const OCR_Options* options, int blocking) {
+  DetectParams dp;
+  read_options(options, dp);
+  OcrPipeline::Request req;
+  req.image = image;
+  req.padding = dp.padding;
+  req.shortSideLen = dp.short_side_len;
+  req.boxScoreThresh = dp.box_score_thresh;
+  req.boxThresh = dp.box_thresh;
+  req.unClipRatio = dp.un_clip_ratio;
+  req.doAngle = dp.do_angle;
+  req.mostAngle = dp.most_angle;
+  return static_cast<OcrPipeline*>(p)->submit(std::move(req), blocking != 0);
+}
+
+OCRDETECT_OCR_API long long OCRDETECT_OCR_CALL ocr_pipeline_submit(
+  OCR_Pipeline p,
+  const unsigned char* image_data, int width, int height, int channels,
+  const OCR_Options* options, int blocking) {
+  if (!p || !image_data || width <= 0 || height <= 0) return -2;
+  if (channels != 1 && channels != 3 && channels != 4) return -2;
+  // 调用方缓冲区在返回后可能被复用，入队前复制一份
+  cv::Mat mat(height, width, CV_8UC(channels));
+  std::memcpy(mat.data, image_data, static_cast<size_t>(width) * height * channels);
+  return pipeline_submit(p, mat, options, blocking);
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_pipeline_poll(
+  OCR_Pipeline p, int timeout_ms, long long* seq, OCR_Result* result) {
+  if (!p || !result) return -1;
+  result->count = 0;
+  result->blocks = nullptr;
+  result->detect_time_ms = 0;
+  OcrPipeline::Output out;
+  if (!static_cast<OcrPipeline*>(p)->poll(out, timeout_ms)) return 0;
+  if (seq) *seq = out.seq;
+  if (!out.error.empty()) {
+    result->count = -1;
+    return 1;
+  }
+  fill_result(out.result, result);
+  return 1;
+}
+
+OCRDETECT_OCR_API OCR_Stream OCRDETECT_OCR_CALL ocr_stream_create(
+  OCR_Handle h, int width, int pixel_format, int band_height, int overlap,
+  const OCR_Options* options, OCR_BlockCallback callback, void* user) {
+  bool rgb_order;
+  int channels = format_channels(pixel_format, rgb_order);
+  if (!h || width <= 0 || channels == 0 || !callback) return nullptr;
+  DetectParams dp;
+  read_options(options, dp);
+  OcrStream::Options so;
+  so.padding = dp.padding;
+  so.shortSideLen = dp.short_side_len;
+  so.boxScoreThresh = dp.box_score_thresh;
+  so.boxThresh = dp.box_thresh;
+  so.unClipRatio = dp.un_clip_ratio;
+  so.doAngle = dp.do_angle;
+  so.mostAngle = dp.most_angle;
+  // 每个带的结果转为 C 结构回调，text 在回调返回后释放
+  auto emit = [callback, user](std::vector<TextBlock>& blocks) {
+    std::vector<OCR_TextBlock> out(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) fill_block(blocks[i], &out[i]);
+    callback(user, out.data(), static_cast<int>(out.size()));
+    for (OCR_TextBlock& b : out) free(b.text);
+  };
+  try {
+    return static_cast<void*>(new OcrStream(*static_cast<OcrLite*>(h), width, CV_8UC(channels), rgb_order,
+                                            band_height > 0 ? band_height : 2048,
+                                            overlap >= 0 ? overlap : 128, so, emit));
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_push(
+  OCR_Stream s, const unsigned char* data, int rows, int stride) {
+  if (!s || !data || rows <= 0) return -1;
+  OcrStream* stream = static_cast<OcrStream*>(s);
+  try {
+    // 行像素格式与 ocr_stream_create 一致，只包装不复制，push 时复制进带缓冲区
+    size_t row_bytes = static_cast<size_t>(stream->width()) * CV_ELEM_SIZE(stream->type());
+    if (stride == 0) stride = static_cast<int>(row_bytes);
+    if (stride < 0 || static_cast<size_t>(stride) < row_bytes) return -1;
+    stream->push(cv::Mat(rows, stream->width(), stream->type(), const_cast<unsigned char*>(data),
+                         static_cast<size_t>(stride)));
+    return 0;
+  } catch (...) {
+    return -2;
+  }
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_read(OCR_Stream s, OCR_RowReader reader, void* user) {
+  if (!s || !reader) return -1;
+  try {
+    // reader 直接写入带缓冲区的空闲行，不经过中间缓冲
+    bool ok = static_cast<OcrStream*>(s)->read([reader, user](cv::Mat& dst) {
+      return reader(user, dst.data, static_cast<int>(dst.step), dst.rows);
+    });
+    return ok ? 0 : -1;
+  } catch (...) {
+    return -2;
+  }
+}
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_stream_finish(OCR_Stream s) {
+  if (!s) return -1;
+  try {
+    static_cast<OcrStream*>(s)->finish();
+    return 0;
+  } catch (...) {
+    return -2;
+  }
+}
+
+OCRDETECT_OCR_API void OCRDETECT_OCR_CALL ocr_stream_destroy(OCR_Stream s) {
+  if (s) delete static_cast<OcrStream*>(s);
+}
+
 /* ============================================================
  * C++ 直接 cv::Mat 接口 —— 与 OcrService 调用方式完全一致
  * ============================================================ */
@@ -135,46 +496,37 @@ OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_mat(
   std::vector<OCR_TextBlockCpp>& out) {
   if (!h || image.empty()) return -1;
 
-  int padding = 0, short_side_len = 960;
-  float box_score_thresh = 0.6f, box_thresh = 0.3f, un_clip_ratio = 2.0f;
-  bool do_angle = true, most_angle = true;
-  if (options) {
-    padding = options->padding;
-    short_side_len = options->short_side_len;
-    box_score_thresh = options->box_score_thresh;
-    box_thresh = options->box_thresh;
-    un_clip_ratio = options->un_clip_ratio;
-    do_angle = (options->do_angle != 0);
-    most_angle = (options->most_angle != 0);
-  }
+  DetectParams p;
+  read_options(options, p);
 
   // 与 OcrService 中 ocr_engine_->detect(image, ...) 完全一致：
   // 直接传递 cv::Mat 引用，不经过原始字节拆解/重建
-  OcrResult res = static_cast<OcrLite*>(h)->detect(image, padding, short_side_len,
-    box_score_thresh, box_thresh, un_clip_ratio, do_angle, most_angle);
+  OcrResult res = static_cast<OcrLite*>(h)->detect(image, p.padding, p.short_side_len,
+    p.box_score_thresh, p.box_thresh, p.un_clip_ratio, p.do_angle, p.most_angle);
 
-  out.clear();
-  out.reserve(res.textBlocks.size());
-  for (size_t i = 0; i < res.textBlocks.size(); ++i) {
-    const TextBlock& b = res.textBlocks[i];
-    OCR_TextBlockCpp tb;
-    size_t pts = b.boxPoint.size();
-    if (pts > 4) pts = 4;
-    for (size_t k = 0; k < pts; k++) {
-      tb.box[k][0] = static_cast<float>(b.boxPoint[k].x);
-      tb.box[k][1] = static_cast<float>(b.boxPoint[k].y);
-    }
-    for (size_t k = pts; k < 4; k++) { tb.box[k][0] = 0; tb.box[k][1] = 0; }
-    tb.box_score = b.boxScore;
-    tb.text = b.text;
-    if (b.charScores.empty()) {
-      tb.confidence = 0.f;
-    } else {
-      float sum = 0;
-      for (float s : b.charScores) sum += s;
-      tb.confidence = sum / static_cast<float>(b.charScores.size());
-    }
-    out.push_back(std::move(tb));
-  }
+  fill_blocks_cpp(res, out);
   return static_cast<int>(out.size());
 }
+
+OCRDETECT_OCR_API int OCRDETECT_OCR_CALL ocr_detect_mat_batch(
+  OCR_Handle h,
+  const std::vector<cv::Mat>& images,
+  const OCR_Options* options,
+  std::vector<std::vector<OCR_TextBlockCpp>>& out) {
+  out.clear();
+  if (!h) return -1;
+  DetectParams p;
+  read_options(options, p);
+  std::vector<OcrResult> res = static_cast<OcrLite*>(h)->detectBatch(images, p.padding, p.short_side_len,
+    p.box_score_thresh, p.box_thresh, p.un_clip_ratio, p.do_angle, p.most_angle);
+  out.resize(res.size());
+  for (size_t i = 0; i < res.size(); ++i)
+    fill_blocks_cpp(res[i], out[i]);
+  return 0;
+}
+
+OCRDETECT_OCR_API long long OCRDETECT_OCR_CALL ocr_pipeline_submit_mat(
+  OCR_Pipeline p, const cv::Mat& image, const OCR_Options* options, int blocking) {
+  if (!p || image.empty() || image.depth() != CV_8U) return -2;
+  return pipeline_submit(p, image, options, blocking);
+}
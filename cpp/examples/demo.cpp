@@ -29,12 +29,11 @@ static void runOcrDemo(const std::string& modelsDir, const std::string& imagePat
     return;
   }
 
-  ocrdetect::OcrEngine engine(modelsDir);
+  ocrdetect::OcrEngine engine(modelsDir, ocrOpt);
   if (!engine.valid()) {
     std::cerr << "OCR 引擎初始化失败，请检查模型目录: " << modelsDir << "\n";
     return;
   }
-  engine.setNumThreads(ocrOpt.num_threads);
 
   fs::path pPre(imagePath);
   std::string preprocessPath = (pPre.parent_path() / (pPre.stem().string() + "_preprocess" + pPre.extension().string())).string();
@@ -127,12 +126,11 @@ static void runCombinedDemo(const std::string& modelsDir, const std::string& ima
     return;
   }
 
-  ocrdetect::OcrEngine engine(modelsDir);
+  ocrdetect::OcrEngine engine(modelsDir, ocrOpt);
   if (!engine.valid()) {
     std::cerr << "OCR 引擎初始化失败\n";
     return;
   }
-  engine.setNumThreads(ocrOpt.num_threads);
 
   const auto& r = matches[0];
   std::vector<cv::Point2f> pts = {
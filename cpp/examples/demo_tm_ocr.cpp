@@ -121,12 +121,11 @@ int main(int argc, char* argv[]) {
 
   // Step 2: OCR 引擎
   std::cout << "\n--- Step 2: OCR 识别 ---\n";
-  ocrdetect::OcrEngine engine(modelsDir);
+  ocrdetect::OcrEngine engine(modelsDir, ocrOpt);
   if (!engine.valid()) {
     std::cerr << "错误: OCR 引擎初始化失败，请检查模型目录: " << modelsDir << "\n";
     return -1;
   }
-  engine.setNumThreads(ocrOpt.num_threads);
 
   cv::Mat visImg = scene.clone();
   std::string fullText;
@@ -78,13 +78,12 @@ int main(int argc, char* argv[]) {
     auto ocrOpt = ocrdetect::loadOcrDetectConfigFromFileWithFallback(ocrPaths, &ocrLoaded);
 
     printf("models_dir: %s\n", modelsDir.c_str());
-    ocrdetect::OcrEngine engine(modelsDir);
+    ocrdetect::OcrEngine engine(modelsDir, ocrOpt);
     if (!engine.valid()) {
         fprintf(stderr, "ERROR: failed to init OCR engine, check models_dir: %s\n", modelsDir.c_str());
         return 1;
     }
     printf("OCR engine initialized.\n");
-    engine.setNumThreads(ocrOpt.num_threads);
 
     cv::Mat img = cv::imread(imagePath);
     if (img.empty()) {
@@ -0,0 +1,88 @@
+/**
+ * @file engine_pool.h
+ * @brief 引擎对象池：每个请求借出一个独占实例，用完自动归还
+ *
+ * OcrEngine / Matcher 实例内部有可变状态，不能被多个请求同时使用；
+ * 池中放 N 个实例，HTTP 线程池中的请求各自借出一个，吞吐随实例数扩展
+ */
+#ifndef OCR_SERVER_ENGINE_POOL_H
+#define OCR_SERVER_ENGINE_POOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace server {
+
+template <typename T>
+class EnginePool {
+public:
+  /** 借出的实例，析构时归还；可移动不可复制 */
+  class Lease {
+  public:
+    Lease(EnginePool* pool, T* item) : pool_(pool), item_(item) {}
+    Lease(Lease&& other) noexcept : pool_(other.pool_), item_(other.item_) {
+      other.pool_ = nullptr;
+      other.item_ = nullptr;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease& operator=(Lease&&) = delete;
+    ~Lease() {
+      if (pool_ && item_) pool_->release(item_);
+    }
+
+    T* operator->() const { return item_; }
+    T& operator*() const { return *item_; }
+
+  private:
+    EnginePool* pool_;
+    T* item_;
+  };
+
+  EnginePool() = default;
+  EnginePool(const EnginePool&) = delete;
+  EnginePool& operator=(const EnginePool&) = delete;
+
+  /** 加入一个实例（启动阶段调用，非线程安全） */
+  void add(std::unique_ptr<T> item) {
+    idle_.push_back(item.get());
+    items_.push_back(std::move(item));
+  }
+
+  size_t size() const { return items_.size(); }
+
+  /** 借出一个空闲实例，全部被占用时阻塞等待 */
+  Lease acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !idle_.empty(); });
+    T* item = idle_.back();
+    idle_.pop_back();
+    return Lease(this, item);
+  }
+
+  /** 对每个实例执行 fn（预热等启动阶段使用，须无请求在途） */
+  template <typename Fn>
+  void forEach(Fn fn) {
+    for (auto& item : items_) fn(*item);
+  }
+
+private:
+  void release(T* item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      idle_.push_back(item);
+    }
+    cv_.notify_one();
+  }
+
+  std::vector<std::unique_ptr<T>> items_;
+  std::vector<T*> idle_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace server
+
+#endif
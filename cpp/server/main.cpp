@@ -1,5 +1,5 @@
 /**
- * C++ 服务端：加载 TM + OCR、预热、HTTP POST /api 按 instruction 分发。
+ * C++ 服务端：加载 TM + OCR 引擎池、预热、HTTP POST /api 按 instruction 分发。
  * 协议见 proto/api.md。
  */
 #include <ocrdetect/OcrEngine.hpp>
@@ -10,6 +10,7 @@
 #include <opencv2/imgproc.hpp>
 #include "base64.h"
 #include "server_config.h"
+#include "engine_pool.h"
 #include "httplib.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
@@ -17,16 +18,18 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <algorithm>
 
 namespace {
 
 std::string config_dir = "config";
 std::string ocr_models_dir;
-std::unique_ptr<ocrdetect::OcrEngine> g_ocr;
-std::unique_ptr<templatematch::Matcher> g_tm;
+// 每个请求从池中借出独占的引擎实例，HTTP 线程池中的请求可并发执行
+server::EnginePool<ocrdetect::OcrEngine> g_ocr_pool;
+server::EnginePool<templatematch::Matcher> g_tm_pool;
 ocrdetect::OcrDetectOptions g_ocr_opt;
 
-bool load_engines() {
+bool load_engines(int ocr_engines, int tm_matchers) {
   std::vector<std::string> tm_paths = {
     config_dir + "/templatematch.conf",
     "config/templatematch.conf",
@@ -49,18 +52,27 @@ bool load_engines() {
   g_ocr_opt = ocrdetect::loadOcrDetectConfigFromFileWithFallback(ocr_paths, &ocr_loaded);
   std::cout << "[config] ocrdetect: " << ocr_loaded << std::endl;
 
-  g_ocr = std::make_unique<ocrdetect::OcrEngine>(ocr_models_dir);
-  if (!g_ocr->valid()) {
-    std::cerr << "OcrEngine init failed." << std::endl;
-    return false;
+  if (!ocrdetect::OcrEngine::configureGlobalThreadPool(g_ocr_opt))
+    std::cerr << "[config] global thread pool ignored: ORT environment already created" << std::endl;
+  // 同进程的多个引擎共享预打包权重；启用 use_mmap + model_cache_dir 时权重也只映射一份
+  for (int i = 0; i < ocr_engines; i++) {
+    auto ocr = std::make_unique<ocrdetect::OcrEngine>(ocr_models_dir, g_ocr_opt);
+    if (!ocr->valid()) {
+      std::cerr << "OcrEngine init failed." << std::endl;
+      return false;
+    }
+    g_ocr_pool.add(std::move(ocr));
   }
-  g_ocr->setNumThreads(g_ocr_opt.num_threads);
 
-  g_tm = std::make_unique<templatematch::Matcher>(tm_params);
-  if (!g_tm->valid()) {
-    std::cerr << "Matcher init failed." << std::endl;
-    return false;
+  for (int i = 0; i < tm_matchers; i++) {
+    auto tm = std::make_unique<templatematch::Matcher>(tm_params);
+    if (!tm->valid()) {
+      std::cerr << "Matcher init failed." << std::endl;
+      return false;
+    }
+    g_tm_pool.add(std::move(tm));
   }
+  std::cout << "[pool] ocr_engines=" << g_ocr_pool.size() << " tm_matchers=" << g_tm_pool.size() << std::endl;
   return true;
 }
 
@@ -68,10 +80,12 @@ void warmup() {
   cv::Mat dummy(64, 256, CV_8UC3);
   dummy.setTo(cv::Scalar(255, 255, 255));
   std::cout << "[warmup] OCR..." << std::endl;
-  (void)g_ocr->detect(dummy, g_ocr_opt, true);
+  g_ocr_pool.forEach([&dummy](ocrdetect::OcrEngine& ocr) { (void)ocr.detect(dummy, g_ocr_opt, true); });
   std::cout << "[warmup] TM..." << std::endl;
-  g_tm->setTemplate(dummy);
-  (void)g_tm->match(dummy);
+  g_tm_pool.forEach([&dummy](templatematch::Matcher& tm) {
+    tm.setTemplate(dummy);
+    (void)tm.match(dummy);
+  });
   std::cout << "[warmup] done." << std::endl;
 }
 
@@ -99,9 +113,13 @@ nlohmann::json handle_tm_only(const nlohmann::json& params) {
   cv::Mat tmpl = decode_image(tmpl_b64);
   if (scene.empty() || tmpl.empty())
     throw std::runtime_error("Invalid image base64");
-  if (!g_tm->setTemplate(tmpl))
-    throw std::runtime_error("tm set_template failed");
-  auto matches = g_tm->match(scene);
+  std::vector<templatematch::MatchResult> matches;
+  {
+    auto tm = g_tm_pool.acquire();
+    if (!tm->setTemplate(tmpl))
+      throw std::runtime_error("tm set_template failed");
+    matches = tm->match(scene);
+  }
   nlohmann::json arr = nlohmann::json::array();
   for (const auto& m : matches) {
     arr.push_back({
@@ -122,8 +140,9 @@ nlohmann::json handle_ocr_only(const nlohmann::json& params) {
   if (img_b64.empty()) throw std::runtime_error("ocr_only requires image");
   cv::Mat img = decode_image(img_b64);
   if (img.empty()) throw std::runtime_error("Invalid image base64");
+  auto ocr = g_ocr_pool.acquire();
   auto t0 = std::chrono::high_resolution_clock::now();
-  auto blocks = g_ocr->detect(img, g_ocr_opt, true);
+  auto blocks = ocr->detect(img, g_ocr_opt, true);
   auto t1 = std::chrono::high_resolution_clock::now();
   double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
   nlohmann::json arr = nlohmann::json::array();
@@ -155,9 +174,17 @@ nlohmann::json handle_tm_then_ocr(const nlohmann::json& params) {
   cv::Mat tmpl = decode_image(tmpl_b64);
   if (scene.empty() || tmpl.empty())
     throw std::runtime_error("Invalid image base64");
-  if (!g_tm->setTemplate(tmpl))
-    throw std::runtime_error("tm set_template failed");
-  auto matches = g_tm->match(scene);
+  std::vector<templatematch::MatchResult> matches;
+  {
+    // 匹配完成即归还，避免同时占用两个池
+    auto tm = g_tm_pool.acquire();
+    if (!tm->setTemplate(tmpl))
+      throw std::runtime_error("tm set_template failed");
+    matches = tm->match(scene);
+  }
+  if (matches.empty())
+    return {{"instruction", "tm_then_ocr"}, {"regions", nlohmann::json::array()}, {"match_count", 0}};
+  auto ocr = g_ocr_pool.acquire();
   nlohmann::json regions = nlohmann::json::array();
   for (const auto& m : matches) {
     std::vector<cv::Point2f> pts = {
@@ -177,7 +204,7 @@ nlohmann::json handle_tm_then_ocr(const nlohmann::json& params) {
       continue;
     }
     cv::Mat crop = scene(roi).clone();
-    auto blocks = g_ocr->detect(crop, g_ocr_opt, true);
+    auto blocks = ocr->detect(crop, g_ocr_opt, true);
     nlohmann::json ocr_arr = nlohmann::json::array();
     for (const auto& b : blocks) {
       nlohmann::json box = nlohmann::json::array();
@@ -242,8 +269,6 @@ int main(int argc, char* argv[]) {
               << " --models <ocr_models_dir> [--config-dir <dir>]\n";
     return 1;
   }
-  if (!load_engines()) return 1;
-  warmup();
 
   // 服务端配置：server/config/server.conf（与 Python 端结构一致）
   server::ConfigMap server_cfg;
@@ -255,6 +280,12 @@ int main(int argc, char* argv[]) {
   };
   if (server::load_server_config(server_conf_paths, server_cfg))
     std::cout << "[config] server.conf loaded" << std::endl;
+  int ocr_engines = std::max(1, server::config_get_int(server_cfg, "pool", "ocr_engines", 1));
+  int tm_matchers = std::max(1, server::config_get_int(server_cfg, "pool", "tm_matchers", 1));
+
+  if (!load_engines(ocr_engines, tm_matchers)) return 1;
+  warmup();
+
   std::string http_host = server::config_get(server_cfg, "server", "host", "0.0.0.0");
   int http_port = server::config_get_int(server_cfg, "server", "port", 8080);
 
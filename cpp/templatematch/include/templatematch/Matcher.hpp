@@ -81,16 +81,12 @@ public:
 
   bool valid() const { return handle_ != nullptr; }
 
-  /** 从 cv::Mat 设置模板（自动转灰度） */
+  /** 从 cv::Mat 设置模板（灰度 / BGR / BGRA，可为 ROI，库内转灰度） */
   bool setTemplate(const cv::Mat& templateImage) {
-    if (!handle_ || templateImage.empty()) return false;
-    cv::Mat gray;
-    if (templateImage.channels() == 1)
-      gray = templateImage;
-    else
-      cv::cvtColor(templateImage, gray, cv::COLOR_BGR2GRAY);
-    return tm_set_template_from_memory(
-      handle_, gray.data, gray.cols, gray.rows, 1) == 0;
+    int format = pixelFormat(templateImage);
+    if (!handle_ || format < 0) return false;
+    return tm_set_template_from_memory_ex(handle_, templateImage.data, templateImage.cols, templateImage.rows,
+      static_cast<int>(templateImage.step[0]), format) == 0;
   }
 
   /** 从文件设置模板 */
@@ -101,15 +97,13 @@ public:
   /** 在图像中匹配，返回结果列表 */
   std::vector<MatchResult> match(const cv::Mat& image) {
     std::vector<MatchResult> out;
-    if (!handle_ || image.empty()) return out;
-    cv::Mat gray;
-    if (image.channels() == 1)
-      gray = image;
-    else
-      cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    int format = pixelFormat(image);
+    if (!handle_ || format < 0) return out;
+    // 按行步长直接传入（ROI 无需先复制为连续内存），彩色图在库内转灰度
     const int maxCount = 512;
     TM_MatchResult results[maxCount];
-    int n = tm_match(handle_, gray.data, gray.cols, gray.rows, 1, results, maxCount);
+    int n = tm_match_ex(handle_, image.data, image.cols, image.rows, static_cast<int>(image.step[0]),
+      format, results, maxCount);
     if (n < 0) return out;
     out.reserve(static_cast<size_t>(n));
     for (int i = 0; i < n; i++)
@@ -120,6 +114,17 @@ public:
   TM_Handle nativeHandle() const { return handle_; }
 
 private:
+  /** 8 位 1/3/4 通道（BGR 顺序）对应的 TM_PixelFormat，不支持时返回 -1 */
+  static int pixelFormat(const cv::Mat& image) {
+    if (image.empty() || image.depth() != CV_8U) return -1;
+    switch (image.channels()) {
+      case 1: return TM_PIXEL_GRAY;
+      case 3: return TM_PIXEL_BGR;
+      case 4: return TM_PIXEL_BGRA;
+      default: return -1;
+    }
+  }
+
   TM_Handle handle_ = nullptr;
 };
 
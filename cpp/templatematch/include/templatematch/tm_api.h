@@ -24,6 +24,15 @@ typedef struct TM_Params {
   double top_angle_step;   /**< 顶层角度步长（度），默认 5.0 */
 } TM_Params;
 
+/** 输入像素格式（*_ex 接口），均为每通道 8 位、交错存储；彩色输入在库内转为灰度 */
+typedef enum TM_PixelFormat {
+  TM_PIXEL_BGR = 0,
+  TM_PIXEL_RGB = 1,
+  TM_PIXEL_BGRA = 2,
+  TM_PIXEL_RGBA = 3,
+  TM_PIXEL_GRAY = 4
+} TM_PixelFormat;
+
 /** 单次匹配结果（与 C++ MatchResult 对应） */
 typedef struct TM_MatchResult {
   double left_top_x, left_top_y;
@@ -60,6 +69,16 @@ TEMPLATEMATCH_API void TEMPLATEMATCH_CALL tm_destroy(TM_Handle h);
 TEMPLATEMATCH_API int TEMPLATEMATCH_CALL tm_set_template_from_memory(
   TM_Handle h, const unsigned char* data, int width, int height, int channels);
 
+/**
+ * 从带行步长的内存图像设置模板：灰度输入直接引用调用方缓冲区（不复制），彩色输入转为灰度
+ * 匹配器内部会保存模板副本，返回后调用方可释放缓冲区
+ * @param stride       行步长（字节），0 表示紧密排列
+ * @param pixel_format TM_PixelFormat
+ * @return 0 成功，-1 参数错误，-2 像素格式或步长无效，其他 <0 见匹配器错误码
+ */
+TEMPLATEMATCH_API int TEMPLATEMATCH_CALL tm_set_template_from_memory_ex(
+  TM_Handle h, const unsigned char* data, int width, int height, int stride, int pixel_format);
+
 /**
  * 从文件设置模板（自动转灰度）
  * @param h 句柄
@@ -84,6 +103,18 @@ TEMPLATEMATCH_API int TEMPLATEMATCH_CALL tm_match(
   const unsigned char* image_data, int width, int height, int channels,
   TM_MatchResult* results, int max_results);
 
+/**
+ * 在带行步长的内存图像中匹配：灰度输入直接引用调用方缓冲区（不复制），彩色输入转为灰度
+ * 适合直接传入采集 SDK 的帧缓冲或大图中的 ROI
+ * @param stride       行步长（字节），0 表示紧密排列
+ * @param pixel_format TM_PixelFormat
+ * @return 匹配数量（>=0），<0 表示错误（-2 像素格式或步长无效）
+ */
+TEMPLATEMATCH_API int TEMPLATEMATCH_CALL tm_match_ex(
+  TM_Handle h,
+  const unsigned char* image_data, int width, int height, int stride, int pixel_format,
+  TM_MatchResult* results, int max_results);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,7 +5,6 @@
 #include "matcher.h"
 #include "template_matching.h"
 #include <opencv2/opencv.hpp>
-#include <cstring>
 #include <vector>
 
 #include "../include/templatematch/export.h"
@@ -36,6 +35,31 @@ static void to_c(const template_matching::MatchResult& r, TM_MatchResult* c) {
   c->score = r.Score;
 }
 
+/**
+ * 把调用方像素包装为灰度 cv::Mat：灰度只建图像头（不复制），彩色转为灰度
+ * @return 像素格式或步长无效时返回空 Mat
+ */
+static cv::Mat wrap_gray(const unsigned char* data, int width, int height, int stride, int pixel_format) {
+  int channels;
+  int code;
+  switch (pixel_format) {
+    case TM_PIXEL_GRAY: channels = 1; code = -1; break;
+    case TM_PIXEL_BGR: channels = 3; code = cv::COLOR_BGR2GRAY; break;
+    case TM_PIXEL_RGB: channels = 3; code = cv::COLOR_RGB2GRAY; break;
+    case TM_PIXEL_BGRA: channels = 4; code = cv::COLOR_BGRA2GRAY; break;
+    case TM_PIXEL_RGBA: channels = 4; code = cv::COLOR_RGBA2GRAY; break;
+    default: return cv::Mat();
+  }
+  size_t row_bytes = static_cast<size_t>(width) * channels;
+  if (stride == 0) stride = static_cast<int>(row_bytes);
+  if (stride < 0 || static_cast<size_t>(stride) < row_bytes) return cv::Mat();
+  cv::Mat src(height, width, CV_8UC(channels), const_cast<unsigned char*>(data), static_cast<size_t>(stride));
+  if (code < 0) return src;
+  cv::Mat gray;
+  cv::cvtColor(src, gray, code);
+  return gray;
+}
+
 TM_Handle TEMPLATEMATCH_CALL tm_create(const TM_Params* params) {
   template_matching::MatcherParam p;
   to_param(params, p);
@@ -56,11 +80,16 @@ int TEMPLATEMATCH_CALL tm_set_template_from_memory(
     TM_Handle h, const unsigned char* data, int width, int height, int channels) {
   if (!h || !data || width <= 0 || height <= 0) return -1;
   if (channels != 1) return -2;
-  cv::Mat mat(height, width, CV_8UC1);
-  size_t len = static_cast<size_t>(width * height);
-  std::memcpy(mat.data, data, len);
-  int ret = static_cast<template_matching::Matcher*>(h)->setTemplate(mat);
-  return ret;
+  return tm_set_template_from_memory_ex(h, data, width, height, 0, TM_PIXEL_GRAY);
+}
+
+int TEMPLATEMATCH_CALL tm_set_template_from_memory_ex(
+    TM_Handle h, const unsigned char* data, int width, int height, int stride, int pixel_format) {
+  if (!h || !data || width <= 0 || height <= 0) return -1;
+  cv::Mat mat = wrap_gray(data, width, height, stride, pixel_format);
+  if (mat.empty()) return -2;
+  // setTemplate 内部 clone，包装的调用方缓冲区只在本次调用内被读取
+  return static_cast<template_matching::Matcher*>(h)->setTemplate(mat);
 }
 
 int TEMPLATEMATCH_CALL tm_set_template_from_file(TM_Handle h, const char* file_path) {
@@ -80,8 +109,15 @@ int TEMPLATEMATCH_CALL tm_match(TM_Handle h,
     TM_MatchResult* results, int max_results) {
   if (!h || !image_data || !results || max_results <= 0) return -1;
   if (channels != 1) return -2;
-  cv::Mat mat(height, width, CV_8UC1);
-  std::memcpy(mat.data, image_data, static_cast<size_t>(width * height));
+  return tm_match_ex(h, image_data, width, height, 0, TM_PIXEL_GRAY, results, max_results);
+}
+
+int TEMPLATEMATCH_CALL tm_match_ex(TM_Handle h,
+    const unsigned char* image_data, int width, int height, int stride, int pixel_format,
+    TM_MatchResult* results, int max_results) {
+  if (!h || !image_data || width <= 0 || height <= 0 || !results || max_results <= 0) return -1;
+  cv::Mat mat = wrap_gray(image_data, width, height, stride, pixel_format);
+  if (mat.empty()) return -2;
   std::vector<template_matching::MatchResult> vec;
   int n = static_cast<template_matching::Matcher*>(h)->match(mat, vec);
   if (n < 0) return n;
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把 det/cls/rec 模型改为直接接受 uint8 NHWC（BGR）输入：在图的最前面插入
+Transpose -> Gather(BGR->RGB) -> Cast -> Sub(均值) -> Mul(系数)，归一化交给 ORT 的算子完成。
+
+C++ 侧（OcrDetect）按会话输入类型自动识别：输入为 uint8 时直接写入 BGR 字节，
+不再在 CPU 上逐像素归一化成 float，输入张量内存为原来的 1/4。
+
+模型目录支持两种布局（同 quantize_models.py），输出目录保持相同布局，
+并一起处理已有的 INT8 变体（<名称>.int8.onnx，不含 *.int8.rejected.onnx），模型目录中的字典文件原样复制：
+  C++：<model_dir>/det.onnx、cls.onnx、rec.onnx、ppocr_keys_v1.txt
+  Python：<model_dir>/det/det.onnx、cls/cls.onnx、rec/rec.onnx
+
+用法（工作目录为 python/）:
+  python prepare_uint8_models.py --model_dir ../cpp/OcrDetect/models --out_dir ../cpp/OcrDetect/models_uint8
+"""
+import argparse
+import os
+import shutil
+import sys
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+
+# 与 DbNet / AngleNet / CrnnNet 中的 meanValues / normValues 一致（RGB 顺序）
+PRESETS = {
+    "det": ([0.485 * 255, 0.456 * 255, 0.406 * 255],
+            [1.0 / 0.229 / 255.0, 1.0 / 0.224 / 255.0, 1.0 / 0.225 / 255.0]),
+    "cls": ([127.5, 127.5, 127.5], [1.0 / 127.5, 1.0 / 127.5, 1.0 / 127.5]),
+    "rec": ([127.5, 127.5, 127.5], [1.0 / 127.5, 1.0 / 127.5, 1.0 / 127.5]),
+}
+
+# 校验时动态维度使用的输入尺寸 (H, W)
+CHECK_SIZES = {"det": (96, 128), "cls": (48, 192), "rec": (48, 320)}
+
+KEY_FILES = ("ppocr_keys_v1.txt", "keys.txt")
+
+
+def dim_of(d):
+    if d.HasField("dim_value"):
+        return d.dim_value
+    return d.dim_param or None
+
+
+def graph_input(graph):
+    initializers = {i.name for i in graph.initializer}
+    return next(i for i in graph.input if i.name not in initializers)
+
+
+def prepare(src, dst, mean, scale):
+    """插入预处理节点，输入名不变，返回 False 表示模型已是 uint8 输入"""
+    model = onnx.load(src)
+    graph = model.graph
+    inp = graph_input(graph)
+    tensor_type = inp.type.tensor_type
+    if tensor_type.elem_type == TensorProto.UINT8:
+        return False
+    n, c, h, w = [dim_of(d) for d in tensor_type.shape.dim]
+    if c not in (3, None):
+        raise ValueError(f"输入通道数为 {c}，只支持 3 通道模型")
+
+    name = inp.name
+    prefix = name + "_prep"
+    normalized = name + "_normalized"
+    # 原模型中读取输入的节点改为读取归一化结果
+    for node in graph.node:
+        for k, input_name in enumerate(node.input):
+            if input_name == name:
+                node.input[k] = normalized
+
+    mean_init = numpy_helper.from_array(np.array(mean, np.float32).reshape(1, 3, 1, 1), prefix + "_mean")
+    scale_init = numpy_helper.from_array(np.array(scale, np.float32).reshape(1, 3, 1, 1), prefix + "_scale")
+    order_init = numpy_helper.from_array(np.array([2, 1, 0], np.int64), prefix + "_bgr2rgb")
+    # 转置与通道交换在 uint8 上进行，只搬运 1/4 的字节
+    nodes = [
+        helper.make_node("Transpose", [name], [prefix + "_nchw"], perm=[0, 3, 1, 2]),
+        helper.make_node("Gather", [prefix + "_nchw", order_init.name], [prefix + "_rgb"], axis=1),
+        helper.make_node("Cast", [prefix + "_rgb"], [prefix + "_float"], to=TensorProto.FLOAT),
+        helper.make_node("Sub", [prefix + "_float", mean_init.name], [prefix + "_centered"]),
+        helper.make_node("Mul", [prefix + "_centered", scale_init.name], [normalized]),
+    ]
+
+    new_input = helper.make_tensor_value_info(name, TensorProto.UINT8, [n, h, w, 3])
+    index = list(graph.input).index(inp)
+    graph.input.remove(inp)
+    graph.input.insert(index, new_input)
+    graph.initializer.extend([mean_init, scale_init, order_init])
+    original = list(graph.node)
+    del graph.node[:]
+    graph.node.extend(nodes + original)
+
+    onnx.checker.check_model(model)
+    onnx.save(model, dst)
+    return True
+
+
+def check(src, dst, kind, mean, scale):
+    """同一张随机 BGR 图分别喂给 float 模型（CPU 上归一化）与 uint8 模型，返回输出最大绝对差"""
+    import onnxruntime as ort
+    ref = ort.InferenceSession(src, providers=["CPUExecutionProvider"])
+    out = ort.InferenceSession(dst, providers=["CPUExecutionProvider"])
+    shape = ref.get_inputs()[0].shape
+    n = shape[0] if isinstance(shape[0], int) and shape[0] > 0 else 1
+    h = shape[2] if isinstance(shape[2], int) and shape[2] > 0 else CHECK_SIZES[kind][0]
+    w = shape[3] if isinstance(shape[3], int) and shape[3] > 0 else CHECK_SIZES[kind][1]
+
+    bgr = np.random.default_rng(0).integers(0, 256, size=(n, h, w, 3), dtype=np.uint8)
+    rgb = bgr[..., ::-1].transpose(0, 3, 1, 2).astype(np.float32)
+    x = (rgb - np.array(mean, np.float32).reshape(1, 3, 1, 1)) * np.array(scale, np.float32).reshape(1, 3, 1, 1)
+    y_ref = ref.run(None, {ref.get_inputs()[0].name: x})[0]
+    y_out = out.run(None, {out.get_inputs()[0].name: bgr})[0]
+    return float(np.max(np.abs(y_ref - y_out)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成接受 uint8 NHWC（BGR）输入的模型")
+    parser.add_argument("--model_dir", type=str, required=True, help="原始模型目录")
+    parser.add_argument("--out_dir", type=str, required=True, help="输出目录（布局与原目录相同）")
+    parser.add_argument("--no_check", action="store_true", help="跳过与原模型的输出对比")
+    parser.add_argument("--tolerance", type=float, default=1e-3, help="输出最大绝对差的告警阈值")
+    args = parser.parse_args()
+
+    model_dir = os.path.abspath(args.model_dir)
+    out_dir = os.path.abspath(args.out_dir)
+    if model_dir == out_dir:
+        print("错误: 输出目录不能与原始模型目录相同", file=sys.stderr)
+        return 1
+
+    # 只取 <name>.onnx 与 <name>.int8.onnx，两种目录布局；*.int8.rejected.onnx 等其他文件不处理
+    sources = []
+    for kind in PRESETS:
+        for name in (f"{kind}.onnx", f"{kind}.int8.onnx"):
+            for sub in ("", kind):
+                path = os.path.join(model_dir, sub, name)
+                if os.path.isfile(path):
+                    sources.append((kind, path))
+    if not sources:
+        print(f"错误: 未找到 det/cls/rec 模型: {model_dir}", file=sys.stderr)
+        return 1
+
+    failed = False
+    for kind, src in sources:
+        rel = os.path.relpath(src, model_dir)
+        dst = os.path.join(out_dir, rel)
+        os.makedirs(os.path.dirname(dst), exist_ok=True)
+        mean, scale = PRESETS[kind]
+        if not prepare(src, dst, mean, scale):
+            print(f"{rel}: 已是 uint8 输入，原样复制")
+            shutil.copyfile(src, dst)
+            continue
+        if args.no_check:
+            print(f"{rel}: 完成")
+            continue
+        diff = check(src, dst, kind, mean, scale)
+        ok = diff <= args.tolerance
+        failed |= not ok
+        print(f"{rel}: 输出最大绝对差 {diff:.2e} {'' if ok else '（超过阈值，请检查均值/系数是否与模型匹配）'}")
+
+    for name in KEY_FILES:
+        path = os.path.join(model_dir, name)
+        if os.path.isfile(path):
+            shutil.copyfile(path, os.path.join(out_dir, name))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+离线生成 INT8 动态量化模型（det.int8.onnx / cls.int8.onnx / rec.int8.onnx），并做精度校验。
+
+逐个量化 det、cls、rec：每次只把一个模型替换为量化版，在测试图片上跑全流程，
+与 FP32 全流程的识别文本比较字符错误率（CER）。CER 不超过阈值的变体写在 FP32 模型旁，
+未通过的变体删除；C++ 侧 model_precision=int8 时只加载存在的变体，缺少的模型回退 FP32。
+
+注意：校验只覆盖 Python 全流程（ONNXPaddleOcr 的预处理、后处理与解码），不覆盖 C++ 引擎。
+C++ 侧的缩放、分桶、rec 宽度对齐、拼批与 uint8 输入等与 Python 不同，量化误差的影响可能不同，
+部署前应以 C++ 引擎（model_precision=int8 与 fp32）在业务图片上对比结果。
+
+模型目录支持两种布局：
+  C++：<model_dir>/det.onnx、cls.onnx、rec.onnx、ppocr_keys_v1.txt
+  Python：<model_dir>/det/det.onnx、cls/cls.onnx、rec/rec.onnx，字典在 <model_dir> 或上一级
+
+用法（工作目录为 python/）:
+  python quantize_models.py --model_dir ../cpp/OcrDetect/models
+  python quantize_models.py --model_dir onnxocr/models/ppocrv4 --models rec --max_cer 0.005
+"""
+import argparse
+import glob
+import os
+import sys
+import time
+
+import cv2
+
+_SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+if _SCRIPT_DIR not in sys.path:
+    sys.path.insert(0, _SCRIPT_DIR)
+
+from onnxocr.onnx_paddleocr import ONNXPaddleOcr
+
+MODEL_NAMES = ("det", "cls", "rec")
+
+
+def find_model(model_dir, name):
+    """FP32 模型路径：<dir>/<name>.onnx 或 <dir>/<name>/<name>.onnx"""
+    for path in (os.path.join(model_dir, name + ".onnx"),
+                 os.path.join(model_dir, name, name + ".onnx")):
+        if os.path.isfile(path):
+            return path
+    return None
+
+
+def find_keys(model_dir):
+    for path in (os.path.join(model_dir, "ppocr_keys_v1.txt"),
+                 os.path.join(model_dir, "keys.txt"),
+                 os.path.join(model_dir, "..", "ppocr_keys_v1.txt")):
+        if os.path.isfile(path):
+            return path
+    return None
+
+
+def quantized_path(fp32_path):
+    return fp32_path[:-len(".onnx")] + ".int8.onnx"
+
+
+def quantize(src, dst, per_channel, op_types):
+    from onnxruntime.quantization import QuantType, quantize_dynamic
+    # 权重 int8、激活 uint8（U8S8），x86 VNNI 上走整数点积内核
+    quantize_dynamic(src, dst,
+                     weight_type=QuantType.QInt8,
+                     per_channel=per_channel,
+                     op_types_to_quantize=op_types or None)
+
+
+def edit_distance(a, b):
+    """字符级 Levenshtein 距离"""
+    if len(a) < len(b):
+        a, b = b, a
+    prev = list(range(len(b) + 1))
+    for i, ca in enumerate(a, 1):
+        cur = [i]
+        for j, cb in enumerate(b, 1):
+            cur.append(min(prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + (ca != cb)))
+        prev = cur
+    return prev[-1]
+
+
+def run_pipeline(paths, keys, images):
+    """按给定的 det/cls/rec 路径跑全流程，返回每张图的识别文本（按框顺序换行拼接）与平均耗时"""
+    kwargs = {"use_angle_cls": True, "use_gpu": False,
+              "det_model_dir": paths["det"], "cls_model_dir": paths["cls"], "rec_model_dir": paths["rec"]}
+    if keys:
+        kwargs["rec_char_dict_path"] = keys
+    model = ONNXPaddleOcr(**kwargs)
+    model.ocr(images[0][1])  # 预热，不计时
+    texts = []
+    start = time.time()
+    for _, img in images:
+        result = model.ocr(img)
+        texts.append("\n".join(line[1][0] for line in result[0]))
+    return texts, (time.time() - start) / len(images)
+
+
+def compare(reference, candidate):
+    """返回 (CER, 完全一致的图片数)，CER 为编辑距离总和除以参考文本总长度"""
+    errors = sum(edit_distance(r, c) for r, c in zip(reference, candidate))
+    length = sum(len(r) for r in reference)
+    exact = sum(1 for r, c in zip(reference, candidate) if r == c)
+    return errors / max(length, 1), exact
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成 INT8 动态量化模型并按 CER 校验")
+    parser.add_argument("--model_dir", type=str, required=True, help="FP32 模型目录")
+    parser.add_argument("--models", type=str, default="det,cls,rec", help="要量化的模型，逗号分隔")
+    parser.add_argument("--images", type=str, default=os.path.join(_SCRIPT_DIR, "onnxocr", "test_images"),
+                        help="校验图片目录")
+    parser.add_argument("--max_cer", type=float, default=0.01,
+                        help="允许的 CER（Python 全流程相对 FP32 输出），超过则丢弃该变体；不校验 C++ 引擎")
+    parser.add_argument("--op_types", type=str, default="",
+                        help="只量化这些算子（逗号分隔，如 MatMul,Conv），默认全部支持的算子")
+    parser.add_argument("--no_per_channel", action="store_true", help="按张量而非按通道量化权重")
+    parser.add_argument("--keep_rejected", action="store_true",
+                        help="保留未通过校验的变体（改名为 *.int8.rejected.onnx）")
+    args = parser.parse_args()
+
+    model_dir = os.path.abspath(args.model_dir)
+    fp32 = {name: find_model(model_dir, name) for name in MODEL_NAMES}
+    missing = [name for name, path in fp32.items() if path is None]
+    if missing:
+        print(f"错误: 模型不存在: {', '.join(missing)}（目录 {model_dir}）", file=sys.stderr)
+        return 1
+    keys = find_keys(model_dir)
+
+    images = []
+    for path in sorted(glob.glob(os.path.join(args.images, "*"))):
+        img = cv2.imread(path)
+        if img is not None:
+            images.append((os.path.basename(path), img))
+    if not images:
+        print(f"错误: 没有可读取的校验图片: {args.images}", file=sys.stderr)
+        return 1
+
+    print(f"FP32 基准: {len(images)} 张图片")
+    reference, fp32_time = run_pipeline(fp32, keys, images)
+    print(f"  平均耗时 {fp32_time * 1000:.1f} ms")
+
+    op_types = [t.strip() for t in args.op_types.split(",") if t.strip()]
+    accepted = []
+    for name in [n.strip() for n in args.models.split(",") if n.strip()]:
+        if name not in MODEL_NAMES:
+            print(f"跳过未知模型: {name}", file=sys.stderr)
+            continue
+        dst = quantized_path(fp32[name])
+        print(f"量化 {name}: {fp32[name]} -> {dst}")
+        quantize(fp32[name], dst, not args.no_per_channel, op_types)
+
+        # 只替换当前模型，CER 增量归因于这一个变体
+        paths = dict(fp32)
+        paths[name] = dst
+        candidate, int8_time = run_pipeline(paths, keys, images)
+        cer, exact = compare(reference, candidate)
+        ok = cer <= args.max_cer
+        print(f"  CER {cer:.4%}，文本完全一致 {exact}/{len(images)}，"
+              f"平均耗时 {int8_time * 1000:.1f} ms（FP32 {fp32_time * 1000:.1f} ms）-> {'通过' if ok else '未通过'}")
+        for (image_name, _), r, c in zip(images, reference, candidate):
+            if r != c:
+                print(f"    {image_name}: 编辑距离 {edit_distance(r, c)}")
+
+        if ok:
+            accepted.append(name)
+        elif args.keep_rejected:
+            os.replace(dst, dst[:-len(".onnx")] + ".rejected.onnx")
+        else:
+            os.remove(dst)
+
+    print(f"通过校验的 INT8 变体: {', '.join(accepted) if accepted else '无'}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())